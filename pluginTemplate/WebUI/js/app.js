@@ -7,6 +7,9 @@
 // Import the entire JUCE JavaScript library. The 'Juce' alias is a convention.
 import * as Juce from "./juce/index.js";
 import { initializeMetering } from "./metering.js";
+import { initializeDiagnostics } from "./diagnostics.js";
+import { initializeHistory } from "./history.js";
+import { initializeSpectrum } from "./spectrum.js";
 
 // This event listener ensures that the DOM is fully loaded before we try to manipulate it.
 document.addEventListener('DOMContentLoaded', () => {
@@ -38,6 +41,34 @@ document.addEventListener('DOMContentLoaded', () => {
         console.error("Gain slider element not found.");
     }
 
+    // --- OVERSAMPLING SELECT CONTROL ---
+    const oversamplingSelect = document.getElementById('oversamplingSelect');
+    if (oversamplingSelect) {
+        // The string 'OVERSAMPLING' must match the parameter ID in C++.
+        const oversamplingState = Juce.getComboBoxState('OVERSAMPLING');
+
+        // The choice names come from the C++ parameter, so the options are built from its properties.
+        oversamplingState.propertiesChangedEvent.addListener(() => {
+            oversamplingSelect.replaceChildren(...oversamplingState.properties.choices.map((choice, index) => {
+                const option = document.createElement('option');
+                option.value = index;
+                option.textContent = choice;
+                return option;
+            }));
+            oversamplingSelect.value = oversamplingState.getChoiceIndex();
+        });
+
+        oversamplingSelect.onchange = () => {
+            oversamplingState.setChoiceIndex(Number(oversamplingSelect.value));
+        };
+
+        oversamplingState.valueChangedEvent.addListener(() => {
+            oversamplingSelect.value = oversamplingState.getChoiceIndex();
+        });
+    } else {
+        console.error("Oversampling select element not found.");
+    }
+
     // --- BYPASS BUTTON CONTROL ---
     const bypassCheckbox = document.getElementById('bypassCheckbox');
     if (bypassCheckbox) {
@@ -58,7 +89,60 @@ document.addEventListener('DOMContentLoaded', () => {
         console.error("Bypass checkbox element not found.");
     }
     
+    // --- LIMITER CONTROLS ---
+    const limiterCheckbox = document.getElementById('limiterCheckbox');
+    if (limiterCheckbox) {
+        // Not automatable, because switching it changes the plugin's latency.
+        const limiterToggleState = Juce.getToggleState('LIMITER');
+
+        limiterCheckbox.oninput = () => {
+            limiterToggleState.setValue(limiterCheckbox.checked);
+        };
+
+        limiterToggleState.valueChangedEvent.addListener(() => {
+            limiterCheckbox.checked = limiterToggleState.getValue();
+        });
+    } else {
+        console.error("Limiter checkbox element not found.");
+    }
+
+    /**
+     * Binds a range input to a float parameter and shows its value in the input's label.
+     * @param {string} sliderId - The range input's element ID.
+     * @param {string} labelId - The label's element ID.
+     * @param {string} parameterId - The parameter ID in C++.
+     * @param {function(number): string} format - Formats the plain parameter value.
+     */
+    const bindLabelledSlider = (sliderId, labelId, parameterId, format) => {
+        const slider = document.getElementById(sliderId);
+        const label = document.getElementById(labelId);
+        if (!slider || !label) {
+            console.error(`${parameterId} slider elements not found.`);
+            return;
+        }
+
+        const sliderState = Juce.getSliderState(parameterId);
+
+        const update = () => {
+            slider.value = sliderState.getNormalisedValue();
+            label.textContent = format(sliderState.getScaledValue());
+        };
+
+        slider.oninput = () => {
+            sliderState.setNormalisedValue(slider.value);
+        };
+
+        sliderState.valueChangedEvent.addListener(update);
+        sliderState.propertiesChangedEvent.addListener(update);
+    };
+
+    bindLabelledSlider('ceilingSlider', 'ceilingLabel', 'CEILING', (db) => `Ceiling ${db.toFixed(1)} dB`);
+    bindLabelledSlider('releaseSlider', 'releaseLabel', 'RELEASE', (ms) => `Release ${Math.round(ms)} ms`);
+
     initializeMetering();
+    initializeDiagnostics();
+    initializeSpectrum();
+    initializeHistory();
 
     console.log("Plugin UI initialized.");
 });
@@ -0,0 +1,119 @@
+/**
+ * Diagnostics panel for the plugin's Web UI.
+ * Polls the processBlock profiling statistics while the panel is open.
+ */
+
+import * as Juce from "./juce/index.js";
+
+const POLL_INTERVAL_MS = 500;
+
+/**
+ * Fetches a JSON resource from the C++ DynamicResourceProvider.
+ * @param {string} resourceName - The endpoint, e.g. "profiling.json".
+ * @returns {Promise<object|null>} The parsed response, or null on failure.
+ */
+const fetchJson = async (resourceName) => {
+    try {
+        const response = await fetch(Juce.getBackendResourceAddress(resourceName));
+        return response.ok ? await response.json() : null;
+    } catch (error) {
+        console.error(`Could not fetch ${resourceName}.`, error);
+        return null;
+    }
+};
+
+const formatMicroseconds = (us) => us.toFixed(1);
+const formatPercent = (ratio) => (ratio * 100).toFixed(1) + '%';
+
+/**
+ * Draws the block load histogram, one bar per bucket, with the deadline marked.
+ * @param {HTMLCanvasElement} canvas - The histogram canvas.
+ * @param {object} load - The "load" object of profiling.json.
+ */
+const drawLoadHistogram = (canvas, load) => {
+    const context = canvas.getContext('2d');
+    const { width, height } = canvas;
+    const histogram = load.histogram;
+    const maxCount = Math.max(1, ...histogram);
+    const barWidth = width / histogram.length;
+
+    context.clearRect(0, 0, width, height);
+
+    histogram.forEach((count, bucket) => {
+        // Logarithmic, so rare slow blocks stay visible next to the common case.
+        const barHeight = count > 0 ? height * Math.log1p(count) / Math.log1p(maxCount) : 0;
+        context.fillStyle = (bucket + 1) * load.bucketWidth > 1.0 ? '#ff4500' : '#00ff00';
+        context.fillRect(bucket * barWidth, height - barHeight, Math.max(1, barWidth - 1), barHeight);
+    });
+
+    const deadlineX = width * (1.0 / load.bucketWidth) / histogram.length;
+    context.fillStyle = '#ffdd00';
+    context.fillRect(deadlineX, 0, 1, height);
+};
+
+/**
+ * Renders one profiling.json response into the panel.
+ * @param {object} profiling - The parsed profiling.json.
+ */
+const renderProfiling = (profiling) => {
+    const stagesBody = document.getElementById('diagnostics-stages');
+    stagesBody.replaceChildren(...profiling.stages.map((stage) => {
+        const row = document.createElement('tr');
+        [stage.name, formatMicroseconds(stage.meanUs), formatMicroseconds(stage.p99Us), formatMicroseconds(stage.maxUs)]
+            .forEach((text) => {
+                const cell = document.createElement('td');
+                cell.textContent = text;
+                row.appendChild(cell);
+            });
+        return row;
+    }));
+
+    const { load, worstBlock } = profiling;
+    document.getElementById('diagnostics-load').textContent =
+        `load mean ${formatPercent(load.mean)}, p99 < ${formatPercent(load.p99)}, overruns ${load.overruns}` +
+        ` | worst ${formatMicroseconds(worstBlock.us)} µs / ${worstBlock.numSamples} samples (${formatPercent(worstBlock.load)})`;
+
+    drawLoadHistogram(document.getElementById('diagnostics-load-histogram'), load);
+};
+
+/**
+ * Initializes the diagnostics panel. It stays hidden in builds compiled without profiling.
+ */
+export async function initializeDiagnostics() {
+    const panel = document.getElementById('diagnostics-panel');
+    const resetButton = document.getElementById('diagnostics-reset');
+
+    if (!panel || !resetButton) {
+        console.error("Diagnostics elements not found.");
+        return;
+    }
+
+    const initial = await fetchJson('profiling.json');
+    if (!initial || !initial.enabled)
+        return;
+
+    panel.hidden = false;
+
+    let pollTimer = null;
+    const poll = async () => {
+        const profiling = await fetchJson('profiling.json');
+        if (profiling && profiling.enabled)
+            renderProfiling(profiling);
+    };
+
+    // Only poll while the panel is open, so a closed panel costs nothing.
+    panel.addEventListener('toggle', () => {
+        clearInterval(pollTimer);
+        pollTimer = null;
+
+        if (panel.open) {
+            poll();
+            pollTimer = setInterval(poll, POLL_INTERVAL_MS);
+        }
+    });
+
+    resetButton.onclick = async () => {
+        await fetchJson('profilingReset.json');
+        poll();
+    };
+}
@@ -0,0 +1,234 @@
+/**
+ * Level history view for the plugin's Web UI.
+ * Draws the output peak and momentary loudness over minutes to hours from the
+ * C++ LevelHistory, with mouse wheel zoom and drag scrolling.
+ *
+ * The backend keeps a min/max pyramid: level k has one point per
+ * pointSeconds * 2^k. The view always draws the coarsest level that still has
+ * at least one point per pixel, and keeps a cache per level. Each request asks
+ * for the points after the last one cached, so zooming and scrolling only
+ * redraw from the cache and nothing is ever fetched twice.
+ */
+
+import * as Juce from "./juce/index.js";
+
+// Must match LevelHistoryEncoder in the C++ plugin.
+const HISTORY_MAGIC = 0x484c5450; // "PTLH"
+const HISTORY_VERSION = 1;
+const HISTORY_HEADER_SIZE = 36;
+const QUANTITY_OUTPUT_PEAK = 1;
+const QUANTITY_MOMENTARY = 2;
+
+const MAX_POINTS_PER_LEVEL = 1024;   // LevelHistory::capacity; older points are dropped.
+const POLL_INTERVAL_MS = 500;
+const MIN_DB = -60.0;
+const MAX_DB = 0.0;
+const MIN_VIEW_SECONDS = 5;
+const MAX_VIEW_SECONDS = 2 * 24 * 3600;
+
+/**
+ * Parses a levelHistory.bin response.
+ * @param {ArrayBuffer} buffer - The response body.
+ * @returns {object|null} The response, or null if it has an unexpected layout.
+ */
+const parseHistory = (buffer) => {
+    if (buffer.byteLength < HISTORY_HEADER_SIZE)
+        return null;
+
+    const view = new DataView(buffer);
+    if (view.getUint32(0, true) !== HISTORY_MAGIC || view.getUint16(4, true) !== HISTORY_VERSION)
+        return null;
+
+    const numQuantities = view.getUint16(28, true);
+    const numPoints = view.getUint32(32, true);
+    if (buffer.byteLength < HISTORY_HEADER_SIZE + 8 * numQuantities * numPoints)
+        return null;
+
+    return {
+        level: view.getUint16(6, true),
+        first: Number(view.getBigUint64(8, true)),
+        nextSince: Number(view.getBigUint64(16, true)),
+        pointSeconds: view.getFloat32(24, true),
+        numQuantities,
+        numLevels: view.getUint16(30, true),
+        values: new Float32Array(buffer.slice(HISTORY_HEADER_SIZE, HISTORY_HEADER_SIZE + 8 * numQuantities * numPoints)),
+        numPoints,
+    };
+};
+
+/** The cached points of one level: a contiguous run of point numbers [first, next). */
+class LevelCache {
+    constructor() {
+        this.first = 0;
+        this.next = 0;
+        this.pointSeconds = 0;
+        this.numQuantities = 0;
+        this.points = [];   // Float32Array per point: Q minima, then Q maxima.
+        this.request = null;
+    }
+
+    /** Appends a response; a gap, i.e. points overwritten in between, restarts the run. */
+    append(response) {
+        this.pointSeconds = response.pointSeconds;
+        this.numQuantities = response.numQuantities;
+
+        if (response.first !== this.next)
+            this.points = [];
+
+        if (this.points.length === 0)
+            this.first = response.first;
+
+        const stride = 2 * response.numQuantities;
+        for (let i = 0; i < response.numPoints; ++i)
+            this.points.push(response.values.subarray(i * stride, (i + 1) * stride));
+
+        if (this.points.length > MAX_POINTS_PER_LEVEL) {
+            const excess = this.points.length - MAX_POINTS_PER_LEVEL;
+            this.points.splice(0, excess);
+            this.first += excess;
+        }
+
+        this.next = this.first + this.points.length;
+    }
+}
+
+/**
+ * Draws the visible range of a level: the output peak as a min/max band and
+ * the momentary loudness maximum as a line.
+ */
+const drawHistory = (canvas, cache, viewSeconds, offsetSeconds) => {
+    const context = canvas.getContext('2d');
+    const { width, height } = canvas;
+    context.clearRect(0, 0, width, height);
+
+    if (cache.points.length === 0)
+        return;
+
+    const toY = (db) => height * (MAX_DB - Math.min(MAX_DB, Math.max(MIN_DB, db))) / (MAX_DB - MIN_DB);
+    const endSeconds = cache.next * cache.pointSeconds - offsetSeconds;
+    const toX = (index) => width - (endSeconds - (index + 1) * cache.pointSeconds) * width / viewSeconds;
+
+    const firstVisible = Math.max(cache.first, Math.floor((endSeconds - viewSeconds) / cache.pointSeconds) - 1);
+    const lastVisible = Math.min(cache.next - 1, Math.ceil(endSeconds / cache.pointSeconds));
+    const q = cache.numQuantities;
+
+    context.fillStyle = 'rgba(0, 255, 0, 0.4)';
+    for (let index = firstVisible; index <= lastVisible; ++index) {
+        const point = cache.points[index - cache.first];
+        const top = toY(point[q + QUANTITY_OUTPUT_PEAK]);
+        const bottom = toY(point[QUANTITY_OUTPUT_PEAK]);
+        context.fillRect(Math.floor(toX(index)), top, 1, Math.max(1, bottom - top));
+    }
+
+    context.beginPath();
+    for (let index = firstVisible; index <= lastVisible; ++index)
+        context.lineTo(toX(index), toY(cache.points[index - cache.first][q + QUANTITY_MOMENTARY]));
+
+    context.strokeStyle = '#ffcc00';
+    context.stroke();
+};
+
+/**
+ * Initializes the history view. It polls the level the current zoom needs,
+ * redraws from the cache on zoom and scroll, and stops while the page is hidden.
+ */
+export function initializeHistory() {
+    const canvas = document.getElementById('history-canvas');
+    if (!canvas) {
+        console.error("History canvas not found.");
+        return;
+    }
+
+    const caches = [];
+    let basePointSeconds = 0.05;
+    let numLevels = 1;
+    let viewSeconds = 60;
+    let offsetSeconds = 0;   // 0 follows the newest point.
+    let isPolling = false;
+
+    const getCache = (level) => {
+        caches[level] = caches[level] || new LevelCache();
+        return caches[level];
+    };
+
+    // The coarsest level that still has at least one point per pixel.
+    const getLevel = () => {
+        const secondsPerPixel = viewSeconds / canvas.width;
+        const level = Math.floor(Math.log2(Math.max(1, secondsPerPixel / basePointSeconds)));
+        return Math.min(numLevels - 1, level);
+    };
+
+    const redraw = () => drawHistory(canvas, getCache(getLevel()), viewSeconds, offsetSeconds);
+
+    const requestLevel = async (level, cache) => {
+        const response = await fetch(Juce.getBackendResourceAddress(`levelHistory.bin?level=${level}&since=${cache.next}`));
+        const history = response.ok ? parseHistory(await response.arrayBuffer()) : null;
+
+        if (!history)
+            return;
+
+        numLevels = history.numLevels;
+        if (level === 0)
+            basePointSeconds = history.pointSeconds;
+
+        cache.append(history);
+    };
+
+    // At most one request per level is in flight, so a poll and a zoom never both ask for the same points.
+    const fetchLevel = (level) => {
+        const cache = getCache(level);
+        cache.request = cache.request || requestLevel(level, cache).finally(() => { cache.request = null; });
+        return cache.request;
+    };
+
+    const poll = async () => {
+        isPolling = true;
+
+        try {
+            await fetchLevel(getLevel());
+            redraw();
+        } catch (error) {
+            console.error("Could not fetch the level history.", error);
+        }
+
+        if (document.hidden)
+            isPolling = false;
+        else
+            setTimeout(poll, POLL_INTERVAL_MS);
+    };
+
+    canvas.addEventListener('wheel', (event) => {
+        event.preventDefault();
+        const previousLevel = getLevel();
+        viewSeconds = Math.min(MAX_VIEW_SECONDS, Math.max(MIN_VIEW_SECONDS, viewSeconds * (event.deltaY > 0 ? 1.25 : 0.8)));
+        redraw();
+
+        // A level not shown before only needs what its cache is missing.
+        if (getLevel() !== previousLevel)
+            fetchLevel(getLevel()).then(redraw).catch((error) => console.error("Could not fetch the level history.", error));
+    }, { passive: false });
+
+    let dragX = null;
+    canvas.addEventListener('pointerdown', (event) => {
+        dragX = event.clientX;
+        canvas.setPointerCapture(event.pointerId);
+    });
+    canvas.addEventListener('pointermove', (event) => {
+        if (dragX === null)
+            return;
+
+        offsetSeconds = Math.max(0, offsetSeconds + (event.clientX - dragX) * viewSeconds / canvas.width);
+        dragX = event.clientX;
+        redraw();
+    });
+    canvas.addEventListener('pointerup', () => { dragX = null; });
+    // Double click returns to following the newest point.
+    canvas.addEventListener('dblclick', () => { offsetSeconds = 0; redraw(); });
+
+    document.addEventListener('visibilitychange', () => {
+        if (!document.hidden && !isPolling)
+            poll();
+    });
+
+    poll();
+}
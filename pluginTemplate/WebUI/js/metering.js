@@ -1,35 +1,53 @@
 /**
  * Metering module for the plugin's Web UI.
- * Handles fetching level data and updating the meter components.
+ * Handles decoding level data and updating the meter components.
  */
 
 import * as Juce from "./juce/index.js";
 
+// Binary meter frame layout, see MeterFrameEncoder.h. All fields are little-endian.
+const METER_FRAME_MAGIC = 0x464d5450; // "PTMF"
+const METER_FRAME_VERSION = 3;
+const METER_FRAME_HEADER_SIZE = 40;
+const METER_FRAME_MAX_SIZE = METER_FRAME_HEADER_SIZE + 2 * 4 * 16;
+
+// Reused for every frame, so decoding does not allocate typed arrays per event.
+const frameBytes = new Uint8Array(METER_FRAME_MAX_SIZE);
+const frameView = new DataView(frameBytes.buffer);
+
 /**
- * A reusable function to update a meter's bar and text display.
+ * Decodes a Base64 encoded meter frame into the shared frame buffer.
+ * @param {string} base64Frame - The event payload sent by the C++ editor.
+ * @returns {boolean} True if the buffer now holds a valid frame.
+ */
+const decodeMeterFrame = (base64Frame) => {
+    const binary = atob(base64Frame);
+    if (binary.length < METER_FRAME_HEADER_SIZE || binary.length > METER_FRAME_MAX_SIZE)
+        return false;
+
+    for (let i = 0; i < binary.length; ++i)
+        frameBytes[i] = binary.charCodeAt(i);
+
+    return frameView.getUint32(0, true) === METER_FRAME_MAGIC
+        && frameView.getUint16(4, true) === METER_FRAME_VERSION;
+};
+
+/**
+ * Sets a meter bar's height and colour from a level in dB.
  * @param {number} dbValue - The decibel value to display.
  * @param {HTMLElement} meterBar - The meter bar element.
- * @param {HTMLElement} peakValueElement - The text element for the peak value.
  */
-const updateMeter = (dbValue, meterBar, peakValueElement) => {
-    // 1. Update the number box with the precise value
-    const displayDb = isFinite(dbValue) ? dbValue.toFixed(1) : "-inf";
-    peakValueElement.textContent = displayDb + " dB";
-
-    // 2. Define the meter's visual range in dB.
+const updateMeterBar = (dbValue, meterBar) => {
+    // Define the meter's visual range in dB and clamp the incoming value to it.
     const minDb = -60.0;
     const maxDb = 6.0;
-
-    // 3. Clamp the incoming dB value to our meter's visual range for the bar.
     const clampedDb = Math.max(minDb, Math.min(dbValue, maxDb));
 
-    // 4. Convert the clamped dB value to a percentage (0-100).
+    // Convert the clamped dB value to a percentage (0-100) for the bar height.
     const percentage = ((clampedDb - minDb) / (maxDb - minDb)) * 100;
-
-    // 5. Update the meter bar's height.
     meterBar.style.height = percentage + '%';
 
-    // 6. Change color based on the raw dB value.
+    // Change color based on the raw dB value.
     if (dbValue >= 0.0) { // Red from 0dBFS up
         meterBar.style.backgroundColor = '#ff4500';
     } else if (dbValue >= -6.0) { // Yellow from -6dBFS to 0dBFS
@@ -39,9 +57,119 @@ const updateMeter = (dbValue, meterBar, peakValueElement) => {
     }
 };
 
+/**
+ * A reusable function to update a meter's bar and text display.
+ * @param {number} dbValue - The decibel value to display.
+ * @param {HTMLElement} meterBar - The meter bar element.
+ * @param {HTMLElement} peakValueElement - The text element for the peak value.
+ */
+const updateMeter = (dbValue, meterBar, peakValueElement) => {
+    // 1. Update the number box with the precise value
+    const displayDb = isFinite(dbValue) ? dbValue.toFixed(1) : "-inf";
+    peakValueElement.textContent = displayDb + " dB";
+
+    // 2. Update the bar.
+    updateMeterBar(dbValue, meterBar);
+};
+
+// Matches LoudnessMeter::silenceLufs; readings at or below it mean silence or a window that is not full yet.
+const SILENCE_LUFS = -100.0;
+
+/**
+ * Shows the output loudness readings of the current frame.
+ * @param {object} elements - The momentary, shortTerm, integrated and range elements.
+ */
+const updateLoudness = (elements) => {
+    const formatLufs = (lufs) => (lufs > SILENCE_LUFS ? lufs.toFixed(1) : "-inf") + " LUFS";
+
+    elements.momentary.textContent = formatLufs(frameView.getFloat32(20, true));
+    elements.shortTerm.textContent = formatLufs(frameView.getFloat32(24, true));
+    elements.integrated.textContent = formatLufs(frameView.getFloat32(28, true));
+    elements.range.textContent = frameView.getFloat32(32, true).toFixed(1) + " LU";
+};
+
+// The gain reduction bar spans this many dB.
+const GAIN_REDUCTION_RANGE_DB = 24.0;
+
+/**
+ * Shows the limiter's gain reduction of the current frame, growing from the right.
+ * @param {HTMLElement} bar - The gain reduction bar.
+ * @param {HTMLElement} valueElement - The text element for the reduction in dB.
+ */
+const updateGainReduction = (bar, valueElement) => {
+    const reductionDb = Math.max(0.0, -frameView.getFloat32(36, true));
+    bar.style.width = Math.min(100, reductionDb / GAIN_REDUCTION_RANGE_DB * 100) + '%';
+    valueElement.textContent = "GR " + reductionDb.toFixed(1) + " dB";
+};
+
+/**
+ * One narrow meter per channel, rebuilt whenever the channel count changes.
+ */
+class ChannelMeters {
+    /**
+     * @param {HTMLElement} container - The element the channel meters are created in.
+     * @param {string} layoutKey - "input" or "output" in channelLayout.json.
+     */
+    constructor(container, layoutKey) {
+        this.container = container;
+        this.layoutKey = layoutKey;
+        this.bars = [];
+    }
+
+    /**
+     * Creates numChannels meters, labelled with the bus' channel names.
+     * @param {number} numChannels - The channel count of the current frame.
+     * @param {object|null} layout - The parsed channelLayout.json, if available.
+     */
+    rebuild(numChannels, layout) {
+        const names = (layout && layout[this.layoutKey]) || [];
+
+        this.bars = [];
+        this.container.replaceChildren(...Array.from({ length: numChannels }, (_, channel) => {
+            const meter = document.createElement('div');
+            meter.className = 'channel-meter';
+
+            const track = document.createElement('div');
+            track.className = 'channel-meter-track';
+            const bar = document.createElement('div');
+            bar.className = 'meter-bar-class';
+            track.appendChild(bar);
+
+            const label = document.createElement('span');
+            label.className = 'channel-meter-label';
+            label.textContent = names[channel] || String(channel + 1);
+
+            meter.append(track, label);
+            this.bars.push(bar);
+            return meter;
+        }));
+    }
+
+    /**
+     * @param {number} firstOffset - Byte offset of this group's first per-channel level in the frame.
+     */
+    update(firstOffset) {
+        this.bars.forEach((bar, channel) => updateMeterBar(frameView.getFloat32(firstOffset + 4 * channel, true), bar));
+    }
+}
+
+/**
+ * Fetches the channel names of the plugin's buses.
+ * @returns {Promise<object|null>} The layout, or null if it is unavailable.
+ */
+const fetchChannelLayout = async () => {
+    try {
+        const response = await fetch(Juce.getBackendResourceAddress('channelLayout.json'));
+        return response.ok ? await response.json() : null;
+    } catch (error) {
+        console.error('Could not fetch the channel layout.', error);
+        return null;
+    }
+};
+
 /**
  * Initializes all metering components. Finds the DOM elements and sets up
- * the event listener to fetch data from the C++ backend.
+ * the event listener that receives meter frames from the C++ backend.
  */
 export function initializeMetering() {
     const inputMeterBar = document.getElementById('input-meter-bar');
@@ -49,17 +177,74 @@ export function initializeMetering() {
     const outputMeterBar = document.getElementById('output-meter-bar');
     const outputPeakValue = document.getElementById('output-peak-value');
 
-    if (inputMeterBar && outputMeterBar) {
-        // Listen for the 'meterLevels' event dispatched from the C++ timer callback
-        window.__JUCE__.backend.addEventListener("meterLevels", () => {
-            // When the event is received, fetch the corresponding JSON data.
-            fetch(Juce.getBackendResourceAddress("meterLevels.json"))
-                .then(response => response.json()) // Directly parse JSON
-                .then(levelData => {
-                    updateMeter(levelData.input, inputMeterBar, inputPeakValue);
-                    updateMeter(levelData.output, outputMeterBar, outputPeakValue);
-                })
-                .catch(error => console.error('Error fetching meter level:', error));
+    const inputChannelMeters = new ChannelMeters(document.getElementById('input-channel-meters'), 'input');
+    const outputChannelMeters = new ChannelMeters(document.getElementById('output-channel-meters'), 'output');
+    let numMeterChannels = -1;
+
+    const loudnessElements = {
+        momentary: document.getElementById('loudness-momentary'),
+        shortTerm: document.getElementById('loudness-short-term'),
+        integrated: document.getElementById('loudness-integrated'),
+        range: document.getElementById('loudness-range'),
+    };
+    const loudnessResetButton = document.getElementById('loudness-reset');
+    const gainReductionBar = document.getElementById('gain-reduction-bar');
+    const gainReductionValue = document.getElementById('gain-reduction-value');
+
+    const hasLoudnessElements = Object.values(loudnessElements).every((element) => element) && loudnessResetButton;
+
+    if (hasLoudnessElements) {
+        // The audio thread clears integrated loudness and range; the next frame shows the result.
+        loudnessResetButton.onclick = async () => {
+            try {
+                await fetch(Juce.getBackendResourceAddress('loudnessReset.json'));
+                loudnessElements.integrated.textContent = "-inf LUFS";
+                loudnessElements.range.textContent = "0.0 LU";
+            } catch (error) {
+                console.error('Could not reset the loudness meter.', error);
+            }
+        };
+    } else {
+        console.error("Loudness elements not found.");
+    }
+
+    // The frames only carry a channel count; names are fetched once per layout change.
+    const onChannelCountChanged = async (numChannels) => {
+        numMeterChannels = numChannels;
+        inputChannelMeters.rebuild(numChannels, null);
+        outputChannelMeters.rebuild(numChannels, null);
+
+        const layout = await fetchChannelLayout();
+        if (layout && numMeterChannels === numChannels) {
+            inputChannelMeters.rebuild(numChannels, layout);
+            outputChannelMeters.rebuild(numChannels, layout);
+        }
+    };
+
+    if (inputMeterBar && outputMeterBar && inputChannelMeters.container && outputChannelMeters.container) {
+        // Listen for the 'meterLevels' event dispatched from the C++ timer callback.
+        // The frame travels in the event payload, so no extra request is needed.
+        window.__JUCE__.backend.addEventListener("meterLevels", (base64Frame) => {
+            if (!decodeMeterFrame(base64Frame)) {
+                console.error('Invalid meter frame received.');
+                return;
+            }
+
+            updateMeter(frameView.getFloat32(12, true), inputMeterBar, inputPeakValue);
+            updateMeter(frameView.getFloat32(16, true), outputMeterBar, outputPeakValue);
+
+            const numChannels = frameView.getUint16(6, true);
+            if (numChannels !== numMeterChannels)
+                onChannelCountChanged(numChannels);
+
+            if (hasLoudnessElements)
+                updateLoudness(loudnessElements);
+
+            if (gainReductionBar && gainReductionValue)
+                updateGainReduction(gainReductionBar, gainReductionValue);
+
+            inputChannelMeters.update(METER_FRAME_HEADER_SIZE);
+            outputChannelMeters.update(METER_FRAME_HEADER_SIZE + 4 * numChannels);
         });
     } else {
         console.error("Metering elements not found.");
@@ -0,0 +1,124 @@
+/**
+ * Spectrum view for the plugin's Web UI.
+ * Fetches the output spectrum computed by the C++ SpectrumAnalyzer and draws it on a canvas.
+ */
+
+import * as Juce from "./juce/index.js";
+
+// Must match SpectrumAnalyzer in the C++ core.
+const SPECTRUM_MAGIC = 0x50535450; // "PTSP"
+const SPECTRUM_VERSION = 1;
+const SPECTRUM_HEADER_SIZE = 24;
+
+const MIN_DB = -90.0;
+const MAX_DB = 0.0;
+const DEFAULT_INTERVAL_MS = 50;
+const GRID_FREQUENCIES = [100, 1000, 10000];
+
+/**
+ * Parses a spectrum.bin frame.
+ * @param {ArrayBuffer} buffer - The response body.
+ * @returns {object|null} The frame, or null if it has an unexpected layout.
+ */
+const parseSpectrumFrame = (buffer) => {
+    if (buffer.byteLength < SPECTRUM_HEADER_SIZE)
+        return null;
+
+    const view = new DataView(buffer);
+    if (view.getUint32(0, true) !== SPECTRUM_MAGIC || view.getUint16(4, true) !== SPECTRUM_VERSION)
+        return null;
+
+    const numBands = view.getUint16(6, true);
+    if (buffer.byteLength < SPECTRUM_HEADER_SIZE + 4 * numBands)
+        return null;
+
+    return {
+        generation: view.getUint32(8, true),
+        intervalMs: view.getFloat32(12, true),
+        minFrequency: view.getFloat32(16, true),
+        maxFrequency: view.getFloat32(20, true),
+        levels: new Float32Array(buffer.slice(SPECTRUM_HEADER_SIZE, SPECTRUM_HEADER_SIZE + 4 * numBands)),
+    };
+};
+
+/**
+ * Draws the bands as a filled curve over a logarithmic frequency axis.
+ * @param {HTMLCanvasElement} canvas - The spectrum canvas.
+ * @param {object} frame - A parsed spectrum frame.
+ */
+const drawSpectrum = (canvas, frame) => {
+    const context = canvas.getContext('2d');
+    const { width, height } = canvas;
+    const { levels, minFrequency, maxFrequency } = frame;
+    const logRange = Math.log(maxFrequency / minFrequency);
+
+    context.clearRect(0, 0, width, height);
+
+    context.fillStyle = '#555';
+    GRID_FREQUENCIES.forEach((frequency) => {
+        context.fillRect(Math.round(width * Math.log(frequency / minFrequency) / logRange), 0, 1, height);
+    });
+
+    const toY = (db) => height * (MAX_DB - Math.min(MAX_DB, Math.max(MIN_DB, db))) / (MAX_DB - MIN_DB);
+    const bandWidth = width / levels.length;
+
+    context.beginPath();
+    context.moveTo(0, height);
+    levels.forEach((db, band) => context.lineTo((band + 0.5) * bandWidth, toY(db)));
+    context.lineTo(width, height);
+    context.closePath();
+
+    context.fillStyle = 'rgba(0, 255, 0, 0.3)';
+    context.fill();
+    context.strokeStyle = '#00ff00';
+    context.stroke();
+};
+
+/**
+ * Initializes the spectrum view. It polls at the interval the backend announces
+ * in each frame, skips drawing when the frame has not changed and stops while
+ * the page is hidden.
+ */
+export function initializeSpectrum() {
+    const canvas = document.getElementById('spectrum-canvas');
+    if (!canvas) {
+        console.error("Spectrum canvas not found.");
+        return;
+    }
+
+    let lastGeneration = null;
+    let intervalMs = DEFAULT_INTERVAL_MS;
+    let isPolling = false;
+
+    const poll = async () => {
+        isPolling = true;
+
+        try {
+            const response = await fetch(Juce.getBackendResourceAddress('spectrum.bin'));
+            const frame = response.ok ? parseSpectrumFrame(await response.arrayBuffer()) : null;
+
+            if (frame) {
+                intervalMs = frame.intervalMs;
+
+                if (frame.generation !== lastGeneration) {
+                    lastGeneration = frame.generation;
+                    drawSpectrum(canvas, frame);
+                }
+            }
+        } catch (error) {
+            console.error("Could not fetch the spectrum.", error);
+        }
+
+        if (document.hidden)
+            isPolling = false;
+        else
+            setTimeout(poll, intervalMs);
+    };
+
+    document.addEventListener('visibilitychange', () => {
+        if (!document.hidden && !isPolling)
+            poll();
+    });
+
+    poll();
+}
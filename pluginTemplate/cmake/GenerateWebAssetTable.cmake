@@ -0,0 +1,85 @@
+# Generates a header with every file below SOURCE_DIR embedded as a constexpr
+# byte array, its path relative to SOURCE_DIR and its precomputed MIME type.
+# The lookup itself (a compile-time perfect hash) lives in WebAssetTableIndex.h.
+#
+# Usage: cmake -DSOURCE_DIR=<dir> -DOUTPUT_FILE=<header> -P GenerateWebAssetTable.cmake
+
+if(NOT SOURCE_DIR OR NOT OUTPUT_FILE)
+    message(FATAL_ERROR "SOURCE_DIR and OUTPUT_FILE must be set")
+endif()
+
+set(MIME_htm   "text/html")
+set(MIME_html  "text/html")
+set(MIME_txt   "text/plain")
+set(MIME_jpg   "image/jpeg")
+set(MIME_jpeg  "image/jpeg")
+set(MIME_svg   "image/svg+xml")
+set(MIME_ico   "image/vnd.microsoft.icon")
+set(MIME_json  "application/json")
+set(MIME_png   "image/png")
+set(MIME_css   "text/css")
+set(MIME_map   "application/json")
+set(MIME_js    "text/javascript")
+set(MIME_woff2 "font/woff2")
+
+file(GLOB_RECURSE ASSET_FILES LIST_DIRECTORIES false RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/*")
+list(SORT ASSET_FILES)
+
+set(ASSET_ARRAYS "")
+set(ASSET_ENTRIES "")
+set(ASSET_INDEX 0)
+
+foreach(ASSET IN LISTS ASSET_FILES)
+    file(READ "${SOURCE_DIR}/${ASSET}" ASSET_HEX HEX)
+    string(LENGTH "${ASSET_HEX}" ASSET_HEX_LENGTH)
+    math(EXPR ASSET_SIZE "${ASSET_HEX_LENGTH} / 2")
+
+    if(ASSET_SIZE EQUAL 0)
+        set(ASSET_BYTES "0x00")
+    else()
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," ASSET_BYTES "${ASSET_HEX}")
+        string(REGEX REPLACE "((0x..,){24})" "\\1\n    " ASSET_BYTES "${ASSET_BYTES}")
+    endif()
+
+    get_filename_component(ASSET_EXTENSION "${ASSET}" LAST_EXT)
+    string(SUBSTRING "${ASSET_EXTENSION}" 1 -1 ASSET_EXTENSION)
+    string(TOLOWER "${ASSET_EXTENSION}" ASSET_EXTENSION)
+    set(ASSET_MIME "${MIME_${ASSET_EXTENSION}}")
+    if(NOT ASSET_MIME)
+        message(WARNING "No MIME type known for '${ASSET}', serving it without one")
+    endif()
+
+    string(APPEND ASSET_ARRAYS "inline constexpr unsigned char asset${ASSET_INDEX}[] = {\n    ${ASSET_BYTES}\n};\n\n")
+    string(APPEND ASSET_ENTRIES "    Entry {\"${ASSET}\", asset${ASSET_INDEX}, ${ASSET_SIZE}, \"${ASSET_MIME}\"},\n")
+    math(EXPR ASSET_INDEX "${ASSET_INDEX} + 1")
+endforeach()
+
+if(ASSET_INDEX EQUAL 0)
+    message(FATAL_ERROR "No Web UI assets found in ${SOURCE_DIR}")
+endif()
+
+set(HEADER_CONTENT "// Generated by GenerateWebAssetTable.cmake - do not edit.
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace WebUIAssetTable
+{
+struct Entry
+{
+    std::string_view path;
+    const unsigned char* data;
+    std::size_t size;
+    const char* mimeType;
+};
+
+${ASSET_ARRAYS}inline constexpr Entry entries[] = {
+${ASSET_ENTRIES}};
+}
+")
+
+# Only touch the header when its content changed, to avoid needless rebuilds.
+file(WRITE "${OUTPUT_FILE}.tmp" "${HEADER_CONTENT}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT_FILE}.tmp" "${OUTPUT_FILE}")
+file(REMOVE "${OUTPUT_FILE}.tmp")
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @namespace BinaryState
+ * @brief The compact binary format of the plugin state written by getStateInformation().
+ *
+ * Layout, all fields little-endian:
+ *
+ *   offset  size  field
+ *        0     4  magic "PTST"
+ *        4     2  version (1)
+ *        6     2  header size in bytes (16 in version 1)
+ *        8     4  number of parameter entries (P)
+ *       12     4  size of the extra state blob in bytes (B)
+ *   header   8*P  parameter entries: uint32 hashParameterID() of the ID, float32 plain value
+ *  +8*P        B  extra state blob, opaque to this format
+ *
+ * Readers skip header fields they do not know, so later versions may grow
+ * the header without breaking older plugin builds. States written before
+ * this format existed are XML and start with copyXmlToBinary()'s own magic,
+ * which never matches "PTST".
+ */
+namespace BinaryState
+{
+    inline constexpr juce::uint32 magic = 0x54535450; // "PTST" read as a little-endian uint32
+    inline constexpr juce::uint16 version = 1;
+    inline constexpr size_t headerSize = 16;
+    inline constexpr size_t entrySize = 8;
+
+    struct Entry
+    {
+        juce::uint32 idHash = 0;
+        float value = 0.0f;
+    };
+
+    /** Replaces the contents of destination with a state holding the given entries and blob. */
+    inline void write(juce::MemoryBlock& destination, const Entry* entries, size_t numEntries,
+                      const void* blob = nullptr, size_t blobSize = 0)
+    {
+        destination.setSize(headerSize + entrySize * numEntries + blobSize);
+        auto* data = static_cast<char*>(destination.getData());
+
+        const auto writeUInt32 = [&](size_t offset, juce::uint32 value)
+        {
+            value = juce::ByteOrder::swapIfBigEndian(value);
+            std::memcpy(data + offset, &value, sizeof(value));
+        };
+        const auto writeUInt16 = [&](size_t offset, juce::uint16 value)
+        {
+            value = juce::ByteOrder::swapIfBigEndian(value);
+            std::memcpy(data + offset, &value, sizeof(value));
+        };
+
+        writeUInt32(0, magic);
+        writeUInt16(4, version);
+        writeUInt16(6, (juce::uint16) headerSize);
+        writeUInt32(8, (juce::uint32) numEntries);
+        writeUInt32(12, (juce::uint32) blobSize);
+
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+            juce::uint32 valueBits;
+            std::memcpy(&valueBits, &entries[i].value, sizeof(valueBits));
+
+            writeUInt32(headerSize + entrySize * i, entries[i].idHash);
+            writeUInt32(headerSize + entrySize * i + 4, valueBits);
+        }
+
+        if (blobSize > 0)
+            std::memcpy(data + headerSize + entrySize * numEntries, blob, blobSize);
+    }
+
+    /**
+     * @class Reader
+     * @brief A validated, non-owning view of a binary state. Reading never allocates.
+     */
+    class Reader
+    {
+    public:
+        /** Returns false, leaving the reader empty, unless data holds a complete binary state this version can read. */
+        bool open(const void* stateData, size_t stateSize) noexcept
+        {
+            *this = {};
+
+            if (stateData == nullptr || stateSize < headerSize)
+                return false;
+
+            const auto* bytes = static_cast<const char*>(stateData);
+
+            if (readUInt32(bytes) != magic)
+                return false;
+
+            const auto stateHeaderSize = (size_t) readUInt16(bytes + 6);
+            const auto stateNumEntries = (size_t) readUInt32(bytes + 8);
+            const auto stateBlobSize = (size_t) readUInt32(bytes + 12);
+
+            // Compared piecewise so corrupt counts cannot overflow the sum.
+            if (readUInt16(bytes + 4) < 1 || stateHeaderSize < headerSize || stateHeaderSize > stateSize
+                || stateNumEntries > (stateSize - stateHeaderSize) / entrySize
+                || stateBlobSize != stateSize - stateHeaderSize - entrySize * stateNumEntries)
+                return false;
+
+            entries = bytes + stateHeaderSize;
+            numEntries = stateNumEntries;
+            blob = entries + entrySize * numEntries;
+            blobSize = stateBlobSize;
+            return true;
+        }
+
+        [[nodiscard]] size_t getNumEntries() const noexcept { return numEntries; }
+
+        [[nodiscard]] Entry getEntry(size_t index) const noexcept
+        {
+            jassert(index < numEntries);
+
+            Entry entry;
+            entry.idHash = readUInt32(entries + entrySize * index);
+
+            const auto valueBits = readUInt32(entries + entrySize * index + 4);
+            std::memcpy(&entry.value, &valueBits, sizeof(valueBits));
+            return entry;
+        }
+
+        [[nodiscard]] const void* getBlobData() const noexcept { return blob; }
+        [[nodiscard]] size_t getBlobSize() const noexcept { return blobSize; }
+
+    private:
+        static juce::uint32 readUInt32(const char* source) noexcept
+        {
+            juce::uint32 value;
+            std::memcpy(&value, source, sizeof(value));
+            return juce::ByteOrder::swapIfBigEndian(value);
+        }
+
+        static juce::uint16 readUInt16(const char* source) noexcept
+        {
+            juce::uint16 value;
+            std::memcpy(&value, source, sizeof(value));
+            return juce::ByteOrder::swapIfBigEndian(value);
+        }
+
+        const char* entries = nullptr;
+        size_t numEntries = 0;
+        const char* blob = nullptr;
+        size_t blobSize = 0;
+    };
+}
@@ -3,7 +3,13 @@
 #include "WebUtils.h"
 #include <juce_core/juce_core.h>
 #include <juce_gui_extra/juce_gui_extra.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 
 /**
@@ -13,21 +19,62 @@
  * This class acts as a router for data requests from the frontend that are not
  * static files (e.g., parameter values, metering data). It maintains a map of
  * resource names to handler functions.
+ *
+ * A handler can be registered together with a generation function that
+ * returns a counter which changes whenever the handler's output would. The
+ * provider then caches the last Resource per endpoint and serves it again as
+ * long as the generation has not moved. Concurrent requests for the same
+ * endpoint are serialized, so only the first one evaluates the handler and
+ * the others are answered from the freshly filled cache.
+ *
+ * Handlers registered with registerQueryHandler() receive the request's query
+ * parameters, e.g. "history.bin?level=2&since=100", and are evaluated for
+ * every request, one at a time, since their output depends on the query.
+ * Other handlers ignore any query string, so a client can append one to
+ * defeat its cache.
  */
 class DynamicResourceProvider
 {
 public:
     using Resource = juce::WebBrowserComponent::Resource;
     using Handler = std::function<std::optional<Resource>()>;
+    using GenerationFunction = std::function<juce::uint64()>;
+    using QueryHandler = std::function<std::optional<Resource>(const juce::StringPairArray& query)>;
+
+    /** Per-endpoint counters, see getStatistics(). */
+    struct EndpointStatistics
+    {
+        juce::String resourceName;
+        juce::uint64 cacheHits = 0;
+        juce::uint64 cacheMisses = 0;      // i.e. handler evaluations
+        double totalEvaluationMs = 0.0;    // time spent running the handler and serializing
+    };
 
     /**
      * @brief Registers a handler function for a specific resource name.
      * @param resourceName The name of the resource, e.g., "outputLevel.json".
      * @param handler A function that returns a juce::WebBrowserComponent::Resource.
+     * @param generation Optional. A function returning a counter that changes
+     * whenever the handler's output changes; enables caching for this endpoint.
+     */
+    void registerHandler(const juce::String& resourceName, Handler handler, GenerationFunction generation = {})
+    {
+        auto endpoint = std::make_unique<Endpoint>();
+        endpoint->handler = std::move(handler);
+        endpoint->generation = std::move(generation);
+        endpoints[resourceName] = std::move(endpoint);
+    }
+
+    /**
+     * @brief Registers a handler that receives the request's query parameters.
+     * @param resourceName The name of the resource without the query, e.g., "history.bin".
+     * @param handler A function taking the decoded query parameters by name.
      */
-    void registerHandler(const juce::String& resourceName, Handler handler)
+    void registerQueryHandler(const juce::String& resourceName, QueryHandler handler)
     {
-        handlers[resourceName] = std::move(handler);
+        auto endpoint = std::make_unique<Endpoint>();
+        endpoint->queryHandler = std::move(handler);
+        endpoints[resourceName] = std::move(endpoint);
     }
 
     /**
@@ -38,10 +85,49 @@ public:
      */
     std::optional<Resource> handleRequest(const juce::String& resourceName) const
     {
-        if (const auto it = handlers.find(resourceName); it != handlers.end())
-            return it->second();
+        const auto it = endpoints.find(resourceName.upToFirstOccurrenceOf("?", false, false));
+        if (it == endpoints.end())
+            return std::nullopt;
+
+        auto& endpoint = *it->second;
+
+        if (endpoint.queryHandler)
+        {
+            const auto query = parseQuery(resourceName.fromFirstOccurrenceOf("?", false, false));
+            const std::scoped_lock lock {endpoint.evaluationMutex};
+            return endpoint.evaluate(query);
+        }
 
-        return std::nullopt;
+        if (! endpoint.generation)
+            return endpoint.evaluate();
+
+        const auto generation = endpoint.generation();
+        const std::scoped_lock lock {endpoint.evaluationMutex};
+
+        if (endpoint.cachedGeneration == generation && endpoint.cachedResource.has_value())
+        {
+            endpoint.cacheHits.fetch_add(1, std::memory_order_relaxed);
+            return endpoint.cachedResource;
+        }
+
+        endpoint.cachedResource = endpoint.evaluate();
+        endpoint.cachedGeneration = generation;
+        return endpoint.cachedResource;
+    }
+
+    /** @brief Returns the cache and timing counters of every registered endpoint. */
+    std::vector<EndpointStatistics> getStatistics() const
+    {
+        std::vector<EndpointStatistics> statistics;
+        statistics.reserve(endpoints.size());
+
+        for (const auto& [name, endpoint] : endpoints)
+            statistics.push_back({name,
+                                  endpoint->cacheHits.load(std::memory_order_relaxed),
+                                  endpoint->cacheMisses.load(std::memory_order_relaxed),
+                                  (double) endpoint->evaluationNanos.load(std::memory_order_relaxed) / 1.0e6});
+
+        return statistics;
     }
 
     /**
@@ -61,5 +147,45 @@ public:
     }
 
 private:
-    std::unordered_map<juce::String, Handler> handlers;
+    /** Splits "a=1&b=2" into decoded name/value pairs. */
+    static juce::StringPairArray parseQuery(const juce::String& query)
+    {
+        juce::StringPairArray parameters;
+
+        for (const auto& pair : juce::StringArray::fromTokens(query, "&", {}))
+            if (pair.isNotEmpty())
+                parameters.set(juce::URL::removeEscapeChars(pair.upToFirstOccurrenceOf("=", false, false)),
+                               juce::URL::removeEscapeChars(pair.fromFirstOccurrenceOf("=", false, false)));
+
+        return parameters;
+    }
+
+    struct Endpoint
+    {
+        std::optional<Resource> evaluate(const juce::StringPairArray& query = {})
+        {
+            const auto start = std::chrono::steady_clock::now();
+            auto resource = queryHandler ? queryHandler(query) : handler();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+            cacheMisses.fetch_add(1, std::memory_order_relaxed);
+            evaluationNanos.fetch_add((juce::uint64) elapsed.count(), std::memory_order_relaxed);
+            return resource;
+        }
+
+        Handler handler;
+        QueryHandler queryHandler;
+        GenerationFunction generation;
+
+        std::mutex evaluationMutex;
+        std::optional<Resource> cachedResource;
+        juce::uint64 cachedGeneration = 0;
+
+        std::atomic<juce::uint64> cacheHits {0};
+        std::atomic<juce::uint64> cacheMisses {0};
+        std::atomic<juce::uint64> evaluationNanos {0};
+    };
+
+    // Endpoints are heap allocated so their caches can be updated from const request handling.
+    std::unordered_map<juce::String, std::unique_ptr<Endpoint>> endpoints;
 };
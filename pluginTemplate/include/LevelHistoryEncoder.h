@@ -0,0 +1,93 @@
+#pragma once
+
+#include <pluginTemplateCore/LevelHistory.h>
+#include <juce_core/juce_core.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * @class LevelHistoryEncoder
+ * @brief Encodes the points of one LevelHistory level into the binary format read by history.js.
+ *
+ * Layout, all fields little-endian:
+ *
+ *   offset  size  field
+ *        0     4  magic "PTLH"
+ *        4     2  version (1)
+ *        6     2  level
+ *        8     8  uint64 number of the first point in this response
+ *       16     8  uint64 number of the point after the last one in this response, i.e. `since` for the next request
+ *       24     4  float32 seconds per point at this level
+ *       28     2  numQuantities (Q), in LevelHistory::Quantity order
+ *       30     2  numLevels
+ *       32     4  numPoints (P)
+ *       36  8*Q*P points, each Q float32 minima followed by Q float32 maxima
+ *
+ * Only the points from `since` on are sent, up to LevelHistory::capacity per
+ * response, so a client that passes back the written count it last received
+ * never gets a point twice.
+ */
+class LevelHistoryEncoder
+{
+public:
+    static constexpr juce::uint32 magic = 0x484c5450; // "PTLH" read as a little-endian uint32
+    static constexpr juce::uint16 version = 1;
+    static constexpr size_t headerSize = 36;
+    static constexpr size_t pointSize = 2 * sizeof(float) * LevelHistory::numQuantities;
+
+    /** Message or web thread; allocates the response. */
+    [[nodiscard]] std::vector<std::byte> encode(const LevelHistory& history, int level, juce::uint64 since)
+    {
+        level = juce::jlimit(0, LevelHistory::numLevels - 1, level);
+
+        juce::uint64 firstIndex = since;
+        const auto numPoints = history.copyPoints(level, since, points.data(), (int) points.size(), firstIndex);
+        // Taken from what was copied rather than from a second getNumPoints(), which could
+        // already count points written since, so following it never skips one.
+        const auto nextSince = firstIndex + (juce::uint64) numPoints;
+
+        std::vector<std::byte> data(headerSize + pointSize * (size_t) numPoints);
+        size_t offset = 0;
+
+        write(data, offset, juce::ByteOrder::swapIfBigEndian(magic));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian(version));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian((juce::uint16) level));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian(firstIndex));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian(nextSince));
+        writeFloat(data, offset, (float) LevelHistory::getPointSeconds(level));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian((juce::uint16) LevelHistory::numQuantities));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian((juce::uint16) LevelHistory::numLevels));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian((juce::uint32) numPoints));
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            for (const auto value : points[(size_t) i].minimum)
+                writeFloat(data, offset, value);
+
+            for (const auto value : points[(size_t) i].maximum)
+                writeFloat(data, offset, value);
+        }
+
+        return data;
+    }
+
+private:
+    template <typename Value>
+    static void write(std::vector<std::byte>& data, size_t& offset, Value value) noexcept
+    {
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+        offset += sizeof(value);
+    }
+
+    static void writeFloat(std::vector<std::byte>& data, size_t& offset, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write(data, offset, juce::ByteOrder::swapIfBigEndian(bits));
+    }
+
+    // Reused between requests; the endpoint handler is serialized by the caller.
+    std::vector<LevelHistory::Point> points = std::vector<LevelHistory::Point>((size_t) LevelHistory::capacity);
+};
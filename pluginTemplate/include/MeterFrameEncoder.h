@@ -0,0 +1,126 @@
+#pragma once
+
+#include <pluginTemplateCore/MeterTelemetry.h>
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @class MeterFrameEncoder
+ * @brief Encodes meter levels into the fixed-layout binary frame read by metering.js.
+ *
+ * Frame layout, all fields little-endian:
+ *
+ *   offset  size  field
+ *        0     4  magic "PTMF"
+ *        4     2  version (3)
+ *        6     2  numChannels (N)
+ *        8     4  sequence number (low 32 bits)
+ *       12     4  float32 input peak in dB, maximum over all channels
+ *       16     4  float32 output peak in dB, maximum over all channels
+ *       20     4  float32 output momentary loudness in LUFS
+ *       24     4  float32 output short-term loudness in LUFS
+ *       28     4  float32 output integrated loudness in LUFS
+ *       32     4  float32 output loudness range in LU
+ *       36     4  float32 limiter gain in dB, 0 while it does not limit
+ *       40   4*N  float32 input peak in dB per channel
+ *   40+4*N   4*N  float32 output peak in dB per channel
+ *
+ * Frames are encoded into a preallocated buffer and their Base64 form into a
+ * preallocated stream; the only per-frame allocation left is the juce::String
+ * that the event API takes as payload.
+ */
+class MeterFrameEncoder
+{
+public:
+    static constexpr juce::uint32 magic = 0x464d5450; // "PTMF" read as a little-endian uint32
+    static constexpr juce::uint16 version = 3;
+    static constexpr size_t headerSize = 40;
+    static constexpr size_t maxFrameSize = headerSize + 2 * sizeof(float) * MeterFrame::maxChannels;
+
+    MeterFrameEncoder()
+        : base64Stream {base64Storage, false}
+    {
+        base64Stream.preallocate(((maxFrameSize + 2) / 3) * 4 + 1);
+    }
+
+    /** Encodes linear levels for numChannels channels and returns the encoded size in bytes. */
+    size_t encode(juce::uint64 sequence, int numChannels, const float* inputLevels, const float* outputLevels,
+                  const LoudnessReadings& loudness, float limiterGain) noexcept
+    {
+        numChannels = juce::jlimit(0, MeterFrame::maxChannels, numChannels);
+
+        size_t offset = 0;
+        writeUInt32(offset, magic);
+        writeUInt16(offset, version);
+        writeUInt16(offset, (juce::uint16) numChannels);
+        writeUInt32(offset, (juce::uint32) sequence);
+        writeFloat(offset, toDb(findMax(inputLevels, numChannels)));
+        writeFloat(offset, toDb(findMax(outputLevels, numChannels)));
+        writeFloat(offset, loudness.momentaryLufs);
+        writeFloat(offset, loudness.shortTermLufs);
+        writeFloat(offset, loudness.integratedLufs);
+        writeFloat(offset, loudness.loudnessRangeLu);
+        writeFloat(offset, toDb(limiterGain));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            writeFloat(offset, toDb(inputLevels[ch]));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            writeFloat(offset, toDb(outputLevels[ch]));
+
+        frameSize = offset;
+        return frameSize;
+    }
+
+    [[nodiscard]] const std::byte* getData() const noexcept { return frame.data(); }
+    [[nodiscard]] size_t getSize() const noexcept { return frameSize; }
+
+    /** The last encoded frame as Base64 text, for use as an event payload. */
+    [[nodiscard]] juce::String toBase64() noexcept
+    {
+        base64Stream.reset();
+        juce::Base64::convertToBase64(base64Stream, frame.data(), frameSize);
+        return juce::String::fromUTF8(static_cast<const char*>(base64Stream.getData()), (int) base64Stream.getDataSize());
+    }
+
+private:
+    static float toDb(float gain) noexcept { return juce::Decibels::gainToDecibels(gain); }
+
+    static float findMax(const float* levels, int numChannels) noexcept
+    {
+        float maxLevel = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            maxLevel = juce::jmax(maxLevel, levels[ch]);
+        return maxLevel;
+    }
+
+    void writeUInt16(size_t& offset, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(frame.data() + offset, &value, sizeof(value));
+        offset += sizeof(value);
+    }
+
+    void writeUInt32(size_t& offset, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(frame.data() + offset, &value, sizeof(value));
+        offset += sizeof(value);
+    }
+
+    void writeFloat(size_t& offset, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUInt32(offset, bits);
+    }
+
+    std::array<std::byte, maxFrameSize> frame {};
+    size_t frameSize = 0;
+
+    juce::MemoryBlock base64Storage;
+    juce::MemoryOutputStream base64Stream;
+};
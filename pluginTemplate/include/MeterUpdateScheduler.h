@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+
+/**
+ * @class MeterUpdateScheduler
+ * @brief Decides on which display refreshes the editor sends new meter levels to the Web UI.
+ *
+ * Meant to be asked once per display refresh. It lets an update through only if
+ *  - the minimum interval for the current state has passed: display rate
+ *    (capped by activeIntervalMs) while there is signal, idleIntervalMs
+ *    once every level is below the silence threshold, and
+ *  - at least one level moved by more than the visual change threshold
+ *    since the last update that was let through.
+ * A stopped transport or a host that stops calling processBlock produces no
+ * new levels, so nothing is sent at all until something changes.
+ */
+class MeterUpdateScheduler
+{
+public:
+    struct Settings
+    {
+        double activeIntervalMs = 1000.0 / 60.0;
+        double idleIntervalMs = 250.0;
+        float changeThresholdDb = 0.2f;
+        float silenceThresholdDb = -90.0f;
+    };
+
+    enum class Decision
+    {
+        update,     // Send the levels now.
+        tooSoon,    // The levels changed, but the minimum interval has not passed yet.
+        unchanged   // Nothing moved by more than the visual threshold.
+    };
+
+    MeterUpdateScheduler() = default;
+    explicit MeterUpdateScheduler(const Settings& newSettings) : settings(newSettings) {}
+
+    /**
+     * @brief Decides whether the given linear levels should be sent now, and
+     * remembers them as the last sent ones in that case.
+     * @param nowMs A monotonic time in milliseconds.
+     */
+    Decision decide(double nowMs, const float* levels, int numLevels) noexcept
+    {
+        numLevels = juce::jmin(numLevels, maxLevels);
+
+        bool isSilent = true;
+        bool hasChanged = numLevels != numLastLevels;
+
+        for (int i = 0; i < numLevels; ++i)
+        {
+            const auto levelDb = juce::Decibels::gainToDecibels(levels[i]);
+            isSilent = isSilent && levelDb <= settings.silenceThresholdDb;
+            hasChanged = hasChanged || std::abs(levelDb - lastLevelsDb[(size_t) i]) > settings.changeThresholdDb;
+        }
+
+        const auto minimumIntervalMs = isSilent ? settings.idleIntervalMs : settings.activeIntervalMs;
+
+        if (! hasChanged)
+            return Decision::unchanged;
+
+        if (nowMs - lastUpdateMs < minimumIntervalMs)
+            return Decision::tooSoon;
+
+        for (int i = 0; i < numLevels; ++i)
+            lastLevelsDb[(size_t) i] = juce::Decibels::gainToDecibels(levels[i]);
+
+        numLastLevels = numLevels;
+        lastUpdateMs = nowMs;
+        return Decision::update;
+    }
+
+    /** Forces the next call to decide() to send, e.g. after the page was reloaded. */
+    void invalidate() noexcept
+    {
+        numLastLevels = -1;
+        lastUpdateMs = -1.0e9;
+    }
+
+private:
+    static constexpr int maxLevels = 64;
+
+    Settings settings;
+    std::array<float, maxLevels> lastLevelsDb {};
+    int numLastLevels = -1;
+    double lastUpdateMs = -1.0e9;
+};
@@ -1,7 +1,37 @@
 #pragma once
 
 
-#include <juce_audio_processors/juce_audio_processors.h>
+#include "ParameterRegistry.h"
 
-const juce::ParameterID GAIN{"GAIN", 1};
-const juce::ParameterID BYPASS{"BYPASS", 1};
+/**
+ * The plugin's parameters. This table is the single place a parameter is
+ * declared: the APVTS layout, the real-time handles, the smoothers and the
+ * Web UI relays and attachments are all generated from it. The first field
+ * is the parameter's index and must match its position in the table.
+ */
+namespace Parameters
+{
+    //                                       index  ID        version  name    min   max   interval  skew  default  smoothingMs
+    inline constexpr FloatParameterSpec gain   {0,   "GAIN",   1,       "gain", 0.f,  1.f,  0.01f,    0.9f, 1.f,     20.f};
+    //                                       index  ID        version  name      default  label     automatable
+    inline constexpr BoolParameterSpec bypass  {1,   "BYPASS", 1,       "bypass", false,   "Bypass", true};
+
+    // Changing the factor changes the latency, so it must not be automated.
+    inline constexpr std::array<const char*, 4> oversamplingChoices {"Off", "2x", "4x", "8x"};
+    //                                            index  ID              version  name            choices                      numChoices  default  automatable
+    inline constexpr ChoiceParameterSpec oversampling {2,   "OVERSAMPLING", 1,       "oversampling", oversamplingChoices.data(), 4,          0,       false};
+
+    // Switching the limiter on or off changes the latency, so it must not be automated either.
+    //                                        index   ID         version  name       default  label      automatable
+    inline constexpr BoolParameterSpec limiter  {3,   "LIMITER", 1,       "limiter", false,   "Limiter", false};
+    //                                        index   ID         version  name       min    max     interval  skew  default  smoothingMs
+    inline constexpr FloatParameterSpec ceiling {4,   "CEILING", 1,       "ceiling", -12.f, 0.f,    0.1f,     1.f,  -1.f,    50.f};
+    inline constexpr FloatParameterSpec release {5,   "RELEASE", 1,       "release", 10.f,  1000.f, 1.f,      0.4f, 100.f,   50.f};
+
+    inline constexpr auto table = std::make_tuple(gain, bypass, oversampling, limiter, ceiling, release);
+}
+
+using PluginParameters = ParameterRegistry<Parameters::table>;
+
+static_assert(PluginParameters::hasConsistentIndices(), "Parameter indices must match their position in the table");
+static_assert(PluginParameters::hasUniqueIDHashes(), "Parameter IDs must have distinct hashes, rename one of them");
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <tuple>
+
+/**
+ * @file ParameterRegistry.h
+ * @brief Machinery that turns the declarative parameter table in ParameterIDs.h
+ * into the APVTS layout, cached real-time handles and per-parameter smoothers.
+ *
+ * Every parameter is declared exactly once as a constexpr spec carrying its
+ * index in the table. Everything else is generated from the table by folding
+ * over it at compile time, so adding a parameter means adding one line there.
+ */
+
+/**
+ * 32-bit FNV-1a hash of a parameter ID. Stored states identify parameters by
+ * this hash instead of the ID string.
+ */
+constexpr juce::uint32 hashParameterID(const char* id) noexcept
+{
+    juce::uint32 hash = 2166136261u;
+
+    for (; *id != 0; ++id)
+        hash = (hash ^ (juce::uint32) (unsigned char) *id) * 16777619u;
+
+    return hash;
+}
+
+struct FloatParameterSpec
+{
+    std::size_t index;
+    const char* id;
+    int version;
+    const char* name;
+    float minimum;
+    float maximum;
+    float interval;
+    float skew;
+    float defaultValue;
+    float smoothingMs; // Ramp time used when smoothing this parameter; 0 disables smoothing.
+
+    [[nodiscard]] juce::ParameterID getParameterID() const { return {id, version}; }
+
+    [[nodiscard]] std::unique_ptr<juce::RangedAudioParameter> createParameter() const
+    {
+        return std::make_unique<juce::AudioParameterFloat>(
+            getParameterID(), name, juce::NormalisableRange<float>{minimum, maximum, interval, skew}, defaultValue);
+    }
+};
+
+struct BoolParameterSpec
+{
+    std::size_t index;
+    const char* id;
+    int version;
+    const char* name;
+    bool defaultValue;
+    const char* label;
+    bool automatable;
+
+    [[nodiscard]] juce::ParameterID getParameterID() const { return {id, version}; }
+
+    [[nodiscard]] std::unique_ptr<juce::RangedAudioParameter> createParameter() const
+    {
+        return std::make_unique<juce::AudioParameterBool>(
+            getParameterID(), name, defaultValue,
+            juce::AudioParameterBoolAttributes{}.withLabel(label).withAutomatable(automatable));
+    }
+};
+
+struct ChoiceParameterSpec
+{
+    std::size_t index;
+    const char* id;
+    int version;
+    const char* name;
+    const char* const* choices;
+    int numChoices;
+    int defaultIndex;
+    bool automatable;
+
+    [[nodiscard]] juce::ParameterID getParameterID() const { return {id, version}; }
+
+    [[nodiscard]] std::unique_ptr<juce::RangedAudioParameter> createParameter() const
+    {
+        juce::StringArray choiceNames;
+        for (int i = 0; i < numChoices; ++i)
+            choiceNames.add(choices[i]);
+
+        return std::make_unique<juce::AudioParameterChoice>(
+            getParameterID(), name, choiceNames, defaultIndex,
+            juce::AudioParameterChoiceAttributes{}.withAutomatable(automatable));
+    }
+};
+
+/**
+ * @brief Compile-time views of a parameter table, i.e. a std::tuple of specs.
+ */
+template <const auto& table>
+struct ParameterRegistry
+{
+    static constexpr std::size_t numParameters = std::tuple_size_v<std::decay_t<decltype(table)>>;
+
+    /** Calls function(spec) for every parameter in table order. */
+    template <typename Function>
+    static void forEach(Function&& function)
+    {
+        std::apply([&](const auto&... spec) { (function(spec), ...); }, table);
+    }
+
+    /** True if every spec's index matches its position in the table. */
+    static constexpr bool hasConsistentIndices()
+    {
+        std::size_t position = 0;
+        bool consistent = true;
+        std::apply([&](const auto&... spec) { ((consistent = consistent && spec.index == position++), ...); }, table);
+        return consistent;
+    }
+
+    /** The hashParameterID() of every parameter, in table order. */
+    static constexpr std::array<juce::uint32, numParameters> idHashes = std::apply(
+        [](const auto&... spec) { return std::array<juce::uint32, numParameters> {hashParameterID(spec.id)...}; }, table);
+
+    /** True if no two parameter IDs share a hash, so a hash identifies a parameter. */
+    static constexpr bool hasUniqueIDHashes()
+    {
+        for (std::size_t i = 0; i < numParameters; ++i)
+            for (std::size_t j = i + 1; j < numParameters; ++j)
+                if (idHashes[i] == idHashes[j])
+                    return false;
+
+        return true;
+    }
+
+    /** The table index of the parameter with the given ID hash, or -1 if there is none. */
+    static constexpr int findIndexOfIDHash(juce::uint32 idHash) noexcept
+    {
+        for (std::size_t i = 0; i < numParameters; ++i)
+            if (idHashes[i] == idHash)
+                return (int) i;
+
+        return -1;
+    }
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        forEach([&](const auto& spec) { layout.add(spec.createParameter()); });
+        return layout;
+    }
+
+    /**
+     * @class Handles
+     * @brief The parameters' std::atomic<float> values, resolved once from the APVTS.
+     *
+     * Reading a parameter is an array access plus a relaxed atomic load, so the
+     * audio thread never looks parameters up by their string IDs.
+     */
+    class Handles
+    {
+    public:
+        explicit Handles(juce::AudioProcessorValueTreeState& valueTreeState)
+        {
+            forEach([&](const auto& spec)
+            {
+                values[spec.index] = valueTreeState.getRawParameterValue(spec.id);
+                parameters[spec.index] = valueTreeState.getParameter(spec.id);
+                jassert(values[spec.index] != nullptr && parameters[spec.index] != nullptr);
+            });
+        }
+
+        /** The plain (denormalised) value of the parameter at a table index. */
+        [[nodiscard]] float getRawValue(std::size_t index) const noexcept
+        {
+            return values[index]->load(std::memory_order_relaxed);
+        }
+
+        /** The parameter object at a table index, for changing its value from the message thread. */
+        [[nodiscard]] juce::RangedAudioParameter& getParameter(std::size_t index) const noexcept
+        {
+            return *parameters[index];
+        }
+
+        [[nodiscard]] float get(const FloatParameterSpec& spec) const noexcept
+        {
+            return values[spec.index]->load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool get(const BoolParameterSpec& spec) const noexcept
+        {
+            return values[spec.index]->load(std::memory_order_relaxed) >= 0.5f;
+        }
+
+        /** The index of the selected choice. */
+        [[nodiscard]] int get(const ChoiceParameterSpec& spec) const noexcept
+        {
+            return juce::roundToInt(values[spec.index]->load(std::memory_order_relaxed));
+        }
+
+    private:
+        std::array<std::atomic<float>*, numParameters> values {};
+        std::array<juce::RangedAudioParameter*, numParameters> parameters {};
+    };
+
+    /**
+     * @class Smoothers
+     * @brief One linear juce::SmoothedValue per parameter, ramping over the spec's smoothingMs.
+     *
+     * For parameters consumed at block or tile rate, such as the limiter's
+     * CEILING and RELEASE: getNextBlockValue() moves a smoother to the latest
+     * target and advances it by one block. Boolean and choice parameters and
+     * float parameters with smoothingMs == 0 are passed through unchanged.
+     */
+    class Smoothers
+    {
+    public:
+        void prepare(double sampleRate, const Handles& handles)
+        {
+            forEach([&](const auto& spec)
+            {
+                auto& smoother = smoothers[spec.index];
+                smoother.reset(sampleRate, getSmoothingSeconds(spec));
+                smoother.setCurrentAndTargetValue((float) handles.get(spec));
+            });
+        }
+
+        float getNextBlockValue(const Handles& handles, const FloatParameterSpec& spec, int numSamples) noexcept
+        {
+            auto& smoother = smoothers[spec.index];
+            smoother.setTargetValue(handles.get(spec));
+            return smoother.skip(numSamples);
+        }
+
+    private:
+        static double getSmoothingSeconds(const FloatParameterSpec& spec) { return spec.smoothingMs / 1000.0; }
+        static double getSmoothingSeconds(const BoolParameterSpec&) { return 0.0; }
+        static double getSmoothingSeconds(const ChoiceParameterSpec&) { return 0.0; }
+
+        std::array<juce::SmoothedValue<float>, numParameters> smoothers;
+    };
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ParameterIDs.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @class ParameterWebBindings
+ * @brief The Web UI relays and parameter attachments for every parameter in the table.
+ *
+ * Float parameters get a juce::WebSliderRelay, bool parameters a
+ * juce::WebToggleButtonRelay and choice parameters a juce::WebComboBoxRelay,
+ * each named after the parameter ID, so the frontend reaches them with
+ * Juce.getSliderState("<ID>"), getToggleState("<ID>") or getComboBoxState("<ID>").
+ * Must outlive the juce::WebBrowserComponent it was added to.
+ */
+class ParameterWebBindings
+{
+public:
+    ParameterWebBindings()
+    {
+        PluginParameters::forEach([this](const auto& spec) { addRelay(spec); });
+    }
+
+    /** Registers every relay with the browser options; call while building the WebBrowserComponent. */
+    juce::WebBrowserComponent::Options addTo(juce::WebBrowserComponent::Options options)
+    {
+        for (auto& relay : sliderRelays)
+            options = options.withOptionsFrom(*relay);
+
+        for (auto& relay : toggleRelays)
+            options = options.withOptionsFrom(*relay);
+
+        for (auto& relay : comboBoxRelays)
+            options = options.withOptionsFrom(*relay);
+
+        return options;
+    }
+
+    /** Connects the relays to the parameters; call once the WebBrowserComponent exists. */
+    void attach(juce::AudioProcessorValueTreeState& valueTreeState)
+    {
+        size_t sliderIndex = 0;
+        size_t toggleIndex = 0;
+        size_t comboBoxIndex = 0;
+
+        PluginParameters::forEach([&](const auto& spec)
+        {
+            auto& parameter = *valueTreeState.getParameter(spec.id);
+
+            using Spec = std::decay_t<decltype(spec)>;
+
+            if constexpr (std::is_same_v<Spec, FloatParameterSpec>)
+                sliderAttachments.push_back(std::make_unique<juce::WebSliderParameterAttachment>(
+                    parameter, *sliderRelays[sliderIndex++], nullptr));
+            else if constexpr (std::is_same_v<Spec, BoolParameterSpec>)
+                toggleAttachments.push_back(std::make_unique<juce::WebToggleButtonParameterAttachment>(
+                    parameter, *toggleRelays[toggleIndex++], nullptr));
+            else
+                comboBoxAttachments.push_back(std::make_unique<juce::WebComboBoxParameterAttachment>(
+                    parameter, *comboBoxRelays[comboBoxIndex++], nullptr));
+        });
+    }
+
+private:
+    void addRelay(const FloatParameterSpec& spec)
+    {
+        sliderRelays.push_back(std::make_unique<juce::WebSliderRelay>(spec.id));
+    }
+
+    void addRelay(const BoolParameterSpec& spec)
+    {
+        toggleRelays.push_back(std::make_unique<juce::WebToggleButtonRelay>(spec.id));
+    }
+
+    void addRelay(const ChoiceParameterSpec& spec)
+    {
+        comboBoxRelays.push_back(std::make_unique<juce::WebComboBoxRelay>(spec.id));
+    }
+
+    std::vector<std::unique_ptr<juce::WebSliderRelay>> sliderRelays;
+    std::vector<std::unique_ptr<juce::WebToggleButtonRelay>> toggleRelays;
+    std::vector<std::unique_ptr<juce::WebComboBoxRelay>> comboBoxRelays;
+    std::vector<std::unique_ptr<juce::WebSliderParameterAttachment>> sliderAttachments;
+    std::vector<std::unique_ptr<juce::WebToggleButtonParameterAttachment>> toggleAttachments;
+    std::vector<std::unique_ptr<juce::WebComboBoxParameterAttachment>> comboBoxAttachments;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterWebBindings)
+};
@@ -2,10 +2,17 @@
 
 #include "PluginProcessor.h"
 #include "DynamicResourceProvider.h"
+#include "LevelHistoryEncoder.h"
+#include "MeterFrameEncoder.h"
+#include "MeterUpdateScheduler.h"
+#include "ParameterWebBindings.h"
+#include "SpectrumWorkerThread.h"
+#include "WebAssetCache.h"
 #include <juce_gui_extra/juce_gui_extra.h>
 
-class JucePluginTemplateAudioProcessorEditor  : public juce::AudioProcessorEditor,
-                                                private juce::Timer
+#include <atomic>
+
+class JucePluginTemplateAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     explicit JucePluginTemplateAudioProcessorEditor (JucePluginTemplateAudioProcessor&);
@@ -14,19 +21,41 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
-    void timerCallback() override;
-
 private:
     void registerDynamicEndpoints();
+    void drainMeterTelemetry();
+    void onDisplayRefresh();
 
     JucePluginTemplateAudioProcessor& _processorRef;
     DynamicResourceProvider _dynamicResourceProvider;
-
-    juce::WebSliderRelay _gainRelay;
-    juce::WebToggleButtonRelay _bypassRelay;
+    juce::SharedResourcePointer<WebAssetCache> _webAssetCache;
+
+    /**
+     * The loudest level per channel over all meter frames drained since the
+     * last update sent to the Web UI. Inputs and outputs are stored back to
+     * back, so the scheduler can look at all of them at once.
+     */
+    std::array<float, 2 * MeterFrame::maxChannels> _meterLevels {};
+    LoudnessReadings _meterLoudness;    // From the latest drained frame.
+    float _meterLimiterGain = 1.0f;     // The smallest over the batch, like the levels.
+    int _numMeterChannels = 0;
+    bool _hasPendingMeterBatch = false;
+    juce::uint64 _meterFrameSequence = 0;
+    MeterFrameEncoder _meterFrameEncoder;
+    LevelHistoryEncoder _levelHistoryEncoder;
+    MeterUpdateScheduler _meterUpdateScheduler;
+    std::atomic<bool> _meterRefreshRequested {false};  // Set when the page is served, see onDisplayRefresh().
+    bool _wasShowing = false;
+
+    // Runs the processor's spectrum analysis while this editor exists.
+    juce::SharedResourcePointer<SpectrumWorkerThread> _spectrumWorkerThread;
+    std::array<std::byte, SpectrumAnalyzer::frameSize> _spectrumFrame {};
+
+    ParameterWebBindings _parameterWebBindings;
     juce::WebBrowserComponent _webBrowserComponent;
-    juce::WebSliderParameterAttachment _gainSliderAttachment;
-    juce::WebToggleButtonParameterAttachment _bypassAttachment;
+
+    // Declared last, so no refresh callback can arrive while members are being destroyed.
+    juce::VBlankAttachment _vBlankAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JucePluginTemplateAudioProcessorEditor)
 };
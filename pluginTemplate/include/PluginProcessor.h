@@ -4,10 +4,25 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include <pluginTemplateCore/DelayBuffer.h>
 #include <pluginTemplateCore/DspProcessor.h>
+#include <pluginTemplateCore/LevelHistory.h>
+#include <pluginTemplateCore/LookaheadLimiter.h>
+#include <pluginTemplateCore/LoudnessMeter.h>
 #include <pluginTemplateCore/PeakLevelMeter.h>
+#include <pluginTemplateCore/MeterTelemetry.h>
+#include <pluginTemplateCore/Oversampler.h>
+#include <pluginTemplateCore/ProcessProfiler.h>
+#include <pluginTemplateCore/SpectrumAnalyzer.h>
 
-class JucePluginTemplateAudioProcessor  : public juce::AudioProcessor
+#include "BinaryStateFormat.h"
+#include "ParameterIDs.h"
+#include "WebAssetCache.h"
+
+#include <atomic>
+
+class JucePluginTemplateAudioProcessor  : public juce::AudioProcessor,
+                                          private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     JucePluginTemplateAudioProcessor();
@@ -18,7 +33,14 @@ public:
 
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
+    /** Mono up to 7.1.4 and ambisonics up to third order; see isBusesLayoutSupported(). */
+    [[nodiscard]] static bool isSupportedChannelSet(const juce::AudioChannelSet& channelSet);
+
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    /** Hosts with a 64-bit mix bus can call the double processBlock and skip converting around the plugin. */
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -36,7 +58,16 @@ public:
     const juce::String getProgramName (int index) override;
     void changeProgramName (int index, const juce::String& newName) override;
 
+    enum class StateFormat
+    {
+        binary, // BinaryStateFormat.h, written by default.
+        xml     // The APVTS tree as XML, as written by earlier versions.
+    };
+
     void getStateInformation (juce::MemoryBlock& destData) override;
+    void getStateInformation (juce::MemoryBlock& destData, StateFormat format);
+
+    /** Restores binary states and, for backward compatibility, XML states. */
     void setStateInformation (const void* data, int sizeInBytes) override;
 
     [[nodiscard]] juce::AudioProcessorValueTreeState& getValueTreeState() noexcept {
@@ -46,22 +77,131 @@ public:
     [[nodiscard]] float getMonoOutputPeakLevelDb() const;
     [[nodiscard]] float getMonoInputPeakLevelDb() const;
 
+    /** Per-block meter frames from the audio thread; the editor is the only consumer. */
+    [[nodiscard]] MeterTelemetryFifo& getMeterTelemetry() noexcept { return _meterTelemetry; }
+
+    /** Min/max history of the meter readings, fed per block whether or not an editor is open. */
+    [[nodiscard]] const LevelHistory& getLevelHistory() const noexcept { return _levelHistory; }
+
+    /** The output spectrum; captures only while an editor has activated it. */
+    [[nodiscard]] SpectrumAnalyzer& getSpectrumAnalyzer() noexcept { return _spectrumAnalyzer; }
+
+    /**
+     * Blocks skipped since prepareToPlay because the processor was asleep: the
+     * input had been digitally silent long enough for every stage's tail to
+     * decay, so the output was cleared and only the meters' release advanced.
+     * Any thread.
+     */
+    [[nodiscard]] juce::uint64 getSkippedBlockCount() const noexcept { return _skippedBlocks.load(std::memory_order_relaxed); }
+
+    /** BS.1770 loudness of the output; readings are also part of each MeterFrame. */
+    [[nodiscard]] LoudnessMeter& getLoudnessMeter() noexcept { return _outputLoudnessMeter; }
+
+   #if PROCESS_PROFILING
+    /** Stage timings of processBlock; only exists in builds with PROCESS_PROFILING enabled. */
+    [[nodiscard]] ProcessProfiler& getProfiler() noexcept { return _profiler; }
+   #endif
 
 private:
-    struct Parameters
-    {
-        juce::AudioParameterFloat* gain   { nullptr };
-        juce::AudioParameterBool* bypass { nullptr };
-    };
-    [[nodiscard]] static juce::AudioProcessorValueTreeState::ParameterLayout
-    createParameterLayout(Parameters&);
+    /** The body of both processBlock overloads. */
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    /**
+     * The first block after bypass: restarts the oversampler and limiter on the dry
+     * signal still in the dry delay, so no samples are skipped or repeated.
+     */
+    template <typename SampleType>
+    void resumeFromBypass();
+
+    /** A silent block while asleep: clears the output and advances the meters without reading samples. */
+    template <typename SampleType>
+    void processSleeping(const juce::dsp::AudioBlock<SampleType>& block);
 
-    Parameters _parameters;
+    /** The gain stage, oversampled when selected. Oversampling is single precision, see processSamples(). */
+    template <typename SampleType>
+    void processGain(const juce::dsp::AudioBlock<SampleType>& block);
+
+    /**
+     * Runs processor over fixed-size sub-blocks with its unrolled kernels and
+     * over the tail with the general ones, reading the gain parameter once per sub-block.
+     */
+    template <typename SampleType>
+    void applyGain(DspProcessor<SampleType>& processor, const juce::dsp::AudioBlock<SampleType>& block);
+
+    template <typename SampleType>
+    [[nodiscard]] LookaheadLimiter<SampleType>& getLimiter() noexcept;
+
+    template <typename SampleType>
+    [[nodiscard]] DelayBuffer<SampleType>& getDryDelay() noexcept;
+
+    template <typename SampleType>
+    [[nodiscard]] juce::AudioBuffer<SampleType>& getWarmUpBuffer() noexcept;
+
+    /** Advances the CEILING and RELEASE smoothers by numSamples and passes them on to the limiter while it runs. */
+    template <typename SampleType>
+    void updateLimiterParameters(LookaheadLimiter<SampleType>& limiter, int numSamples) noexcept;
+
+    /** limiterGain is the smallest gain the limiter applied during the block, 1 when it is off. */
+    void pushMeterFrame(int numSamples, float limiterGain);
+
+    void restoreBinaryState(const BinaryState::Reader& state);
+
+    /** Switches the oversampling factor and re-prepares the oversampled stages. Real-time safe. */
+    void setOversamplingFactor(int factorLog2);
+
+    /** Oversampling plus limiter latency of the factor and limiter state processSamples() runs with. */
+    [[nodiscard]] int getActiveLatencySamples() const noexcept;
+
+    /** Oversampling plus limiter latency for the current OVERSAMPLING and LIMITER values. */
+    [[nodiscard]] int getSelectedLatencySamples() const;
+
+    /**
+     * Reports the latency of the selected oversampling factor and limiter state
+     * to the host. Called off the audio thread, because notifying the host takes locks.
+     */
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
 
     juce::AudioProcessorValueTreeState _valueTreeState;
-    DspProcessor _dspProcessor;
+    // Resolved once here, so processBlock never looks parameters up by ID.
+    PluginParameters::Handles _parameterHandles {_valueTreeState};
+    PluginParameters::Smoothers _parameterSmoothers; // At the host rate, stepped once per tile.
+    juce::dsp::ProcessSpec _processSpec {};
+    Oversampler _oversampler;
+    DspProcessor<float> _dspProcessor;          // Runs at the oversampled rate.
+    DspProcessor<double> _dspProcessorDouble;   // The 64-bit path's gain while oversampling is off.
+    juce::AudioBuffer<float> _oversamplingScratch; // The 64-bit path narrowed for the oversampler.
+    LookaheadLimiter<float> _limiter;           // Runs at the host rate, after downsampling.
+    LookaheadLimiter<double> _limiterDouble;
+    bool _limiterActive = false;
+    // The bypassed output, delayed like the processed one. Only the host's precision gets the full length.
+    DelayBuffer<float> _dryDelay;
+    DelayBuffer<double> _dryDelayDouble;
+    bool _bypassed = false;             // The last block was bypassed.
+    juce::AudioBuffer<float> _warmUpBuffer;         // The dry signal replayed by resumeFromBypass().
+    juce::AudioBuffer<double> _warmUpBufferDouble;
     PeakLevelMeter _outputLevelMeter;
     PeakLevelMeter _inputLevelMeter;
+    LoudnessMeter _outputLoudnessMeter;
+
+    // Sleep mode for silent input, see processSamples().
+    juce::int64 _silentInputSamples = 0;
+    bool _sleeping = false;
+    std::atomic<juce::uint64> _skippedBlocks {0};
+
+    // Keeps the process-wide Web UI assets alive and decoded while any instance exists.
+    juce::SharedResourcePointer<WebAssetCache> _webAssetCache;
+
+    SpectrumAnalyzer _spectrumAnalyzer;
+
+    MeterTelemetryFifo _meterTelemetry;
+    LevelHistory _levelHistory;
+    juce::uint64 _meterFrameSequence = 0;
+    juce::int64 _meterSamplePosition = 0;
+
+   #if PROCESS_PROFILING
+    ProcessProfiler _profiler;
+   #endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JucePluginTemplateAudioProcessor)
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * @class SpectrumWorkerThread
+ * @brief The low-priority thread every open editor's SpectrumAnalyzer runs its analysis on.
+ *
+ * Access it through a juce::SharedResourcePointer<SpectrumWorkerThread>: the
+ * first editor to open starts the thread and the last one to close stops it,
+ * so one thread serves any number of instances and none runs without an editor.
+ */
+class SpectrumWorkerThread : public juce::TimeSliceThread
+{
+public:
+    SpectrumWorkerThread()
+        : juce::TimeSliceThread("Spectrum analyzer")
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+
+    ~SpectrumWorkerThread() override
+    {
+        stopThread(1000);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumWorkerThread)
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "WebUtils.h"
+#include <juce_core/juce_core.h>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#if WEBUI_USE_ASSET_TABLE
+ #include "WebAssetTableIndex.h"
+ #include <WebUIAssetTable.h>
+#else
+ #include <WebUIDataEmbed.h>
+
+ #include <atomic>
+ #include <map>
+ #include <mutex>
+ #include <string>
+ #include <thread>
+ #include <vector>
+#endif
+
+/**
+ * @class WebAssetCache
+ * @brief A process-wide index of the Web UI assets embedded in the plugin binary.
+ *
+ * By default (WEBUI_EMBED_MODE=ZIP) the assets come from BinaryData::WebUI_zip:
+ * the zip's central directory is parsed and every entry is inflated exactly
+ * once per process, the first time any asset is requested (or earlier, on a
+ * background thread, via warmUpAsync()). After that, lookups are lock-free
+ * reads of an immutable map.
+ *
+ * With WEBUI_EMBED_MODE=TABLE the build generates a constexpr table of the
+ * uncompressed assets instead, and a lookup is a compile-time perfect hash
+ * into it: no zip, no decompression, no allocation and nothing to warm up.
+ *
+ * Access it through a juce::SharedResourcePointer<WebAssetCache>, so that all
+ * plugin instances in the process share one cache.
+ */
+class WebAssetCache
+{
+public:
+    /** A view of an asset's bytes; valid for the lifetime of the cache. */
+    struct Asset
+    {
+        const std::byte* data = nullptr;
+        size_t size = 0;
+        const char* mimeType = "";
+    };
+
+    WebAssetCache() = default;
+
+   #if WEBUI_USE_ASSET_TABLE
+    /**
+     * @brief Returns the asset stored under the given path.
+     * @param path A path relative to the Web UI root, e.g. "js/app.js".
+     */
+    std::optional<Asset> find(std::string_view path) const noexcept
+    {
+        static constexpr auto index = WebAssetTableIndex::build(WebUIAssetTable::entries);
+
+        if (const auto* entry = WebAssetTableIndex::find(WebUIAssetTable::entries, index, path))
+            return Asset {reinterpret_cast<const std::byte*>(entry->data), entry->size, entry->mimeType};
+
+        return std::nullopt;
+    }
+
+    /** Nothing to decode ahead of time; kept so callers do not depend on the embed mode. */
+    void warmUpAsync() noexcept {}
+
+   #else
+    ~WebAssetCache()
+    {
+        if (warmUpThread.joinable())
+            warmUpThread.join();
+    }
+
+    /**
+     * @brief Returns the decoded asset stored under the given path inside the zip.
+     * @param path A path relative to the Web UI root, e.g. "js/app.js".
+     */
+    std::optional<Asset> find(std::string_view path)
+    {
+        ensureBuilt();
+
+        if (const auto it = assets.find(path); it != assets.end())
+        {
+            // Only assets that are actually requested need a known type; add it to WebUtils::mimeMap.
+            jassert(it->second.mimeType != nullptr);
+            const auto* mimeType = it->second.mimeType != nullptr ? it->second.mimeType : WebUtils::fallbackMimeType;
+            return Asset {it->second.bytes.data(), it->second.bytes.size(), mimeType};
+        }
+
+        return std::nullopt;
+    }
+
+    /** Starts decoding all assets on a background thread; only the first call has any effect. */
+    void warmUpAsync()
+    {
+        if (! warmUpStarted.exchange(true))
+            warmUpThread = std::thread {[this] { ensureBuilt(); }};
+    }
+
+private:
+    struct DecodedAsset
+    {
+        std::vector<std::byte> bytes;
+        const char* mimeType = nullptr;     // nullptr for extensions missing from WebUtils::mimeMap.
+    };
+
+    void ensureBuilt()
+    {
+        std::call_once(buildFlag, [this] { build(); });
+    }
+
+    void build()
+    {
+        juce::MemoryInputStream zipStream {BinaryData::WebUI_zip, BinaryData::WebUI_zipSize, false};
+        juce::ZipFile zipFile {zipStream};
+
+        for (int i = 0; i < zipFile.getNumEntries(); ++i)
+        {
+            const auto* zipEntry = zipFile.getEntry(i);
+
+            if (zipEntry == nullptr || zipEntry->filename.endsWithChar('/'))
+                continue;
+
+            const std::unique_ptr<juce::InputStream> entryStream {zipFile.createStreamForEntry(i)};
+            if (entryStream == nullptr)
+            {
+                juce::Logger::writeToLog("Web asset cache: FAILED to create stream for file: '" + zipEntry->filename + "'");
+                continue;
+            }
+
+            // The zip may hold files the UI never requests, so unknown types are only
+            // asserted on in find(), not here on the warm-up thread.
+            const auto extension = zipEntry->filename.fromLastOccurrenceOf(".", false, false);
+            assets[zipEntry->filename.toStdString()] = DecodedAsset {WebUtils::streamToVector(*entryStream),
+                                                                     WebUtils::findMimeForExtension(extension)};
+        }
+    }
+
+    // std::less<> allows lookups by std::string_view without building a key string.
+    std::map<std::string, DecodedAsset, std::less<>> assets;
+    std::once_flag buildFlag;
+
+    std::atomic<bool> warmUpStarted {false};
+    std::thread warmUpThread;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(WebAssetCache)
+};
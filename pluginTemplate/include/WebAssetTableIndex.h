@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @namespace WebAssetTableIndex
+ * @brief A compile-time perfect hash over the paths of a generated asset table.
+ *
+ * The seed of an FNV-1a hash is searched at compile time until every path
+ * lands in its own slot of a power-of-two sized table, so a lookup is one
+ * hash, one slot load and one string comparison, without any allocation.
+ */
+namespace WebAssetTableIndex
+{
+    constexpr std::uint32_t hash(std::string_view text, std::uint32_t seed) noexcept
+    {
+        std::uint32_t value = 2166136261u ^ seed;
+        for (const auto c : text)
+            value = (value ^ static_cast<std::uint8_t>(c)) * 16777619u;
+        return value ^ (value >> 15);
+    }
+
+    constexpr std::size_t nextPowerOfTwo(std::size_t value) noexcept
+    {
+        std::size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    template <std::size_t numSlots>
+    struct Index
+    {
+        static constexpr std::int32_t emptySlot = -1;
+
+        std::uint32_t seed = 0;
+        std::array<std::int32_t, numSlots> slots {};
+
+        constexpr std::int32_t getSlot(std::string_view path) const noexcept
+        {
+            return slots[hash(path, seed) & (numSlots - 1)];
+        }
+    };
+
+    /** Builds the collision-free index for the paths of the given entries (anything with a .path member). */
+    template <typename Entry, std::size_t numEntries>
+    constexpr auto build(const Entry (&entries)[numEntries])
+    {
+        constexpr auto numSlots = nextPowerOfTwo(numEntries * 2);
+        Index<numSlots> index;
+
+        for (std::uint32_t seed = 0;; ++seed)
+        {
+            index.seed = seed;
+            for (auto& slot : index.slots)
+                slot = Index<numSlots>::emptySlot;
+
+            bool collisionFree = true;
+
+            for (std::size_t i = 0; i < numEntries && collisionFree; ++i)
+            {
+                auto& slot = index.slots[hash(entries[i].path, seed) & (numSlots - 1)];
+                collisionFree = slot == Index<numSlots>::emptySlot;
+                slot = static_cast<std::int32_t>(i);
+            }
+
+            if (collisionFree)
+                return index;
+        }
+    }
+
+    /** Finds the entry with the given path, or returns nullptr. */
+    template <typename Entry, std::size_t numEntries, std::size_t numSlots>
+    constexpr const Entry* find(const Entry (&entries)[numEntries], const Index<numSlots>& index, std::string_view path) noexcept
+    {
+        const auto slot = index.getSlot(path);
+
+        if (slot != Index<numSlots>::emptySlot && entries[slot].path == path)
+            return &entries[slot];
+
+        return nullptr;
+    }
+}
@@ -2,11 +2,12 @@
 
 #include "WebUtils.h"
 #include "DynamicResourceProvider.h"
+#include "WebAssetCache.h"
 #include <juce_core/juce_core.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 
-#include <WebUIDataEmbed.h>
+#include <string_view>
 
 
 using namespace juce;
@@ -16,84 +17,52 @@ namespace
 {
     constexpr auto LOCAL_DEV_SERVER_ADDRESS = "http://127.0.0.1:8080";
 
-    static const std::unordered_map<String, const char*> mimeMap = {{{"htm"}, "text/html"},
-                                                                    {{"html"}, "text/html"},
-                                                                    {{"txt"}, "text/plain"},
-                                                                    {{"jpg"}, "image/jpeg"},
-                                                                    {{"jpeg"}, "image/jpeg"},
-                                                                    {{"svg"}, "image/svg+xml"},
-                                                                    {{"ico"}, "image/vnd.microsoft.icon"},
-                                                                    {{"json"}, "application/json"},
-                                                                    {{"png"}, "image/png"},
-                                                                    {{"css"}, "text/css"},
-                                                                    {{"map"}, "application/json"},
-                                                                    {{"js"}, "text/javascript"},
-                                                                    {{"woff2"}, "font/woff2"}};
-
-    static inline const char* getMimeForExtension(const String& extension)
+    static inline std::optional<Resource> getStaticFileResource(std::string_view filepath, WebAssetCache& assetCache)
     {
-        if (const auto it = mimeMap.find(extension.toLowerCase()); it != mimeMap.end())
-            return it->second;
+        // The WebBrowserComponent resource API owns its bytes, so this copy is the only one made.
+        if (const auto asset = assetCache.find(filepath))
+            return Resource {{asset->data, asset->data + asset->size}, asset->mimeType};
 
-        jassertfalse;
-        return "";
-    }
-
-    static inline std::vector<std::byte> getWebViewFileAsBytes(const juce::String& filepath)
-    {
-        juce::MemoryInputStream zipStream {BinaryData::WebUI_zip, BinaryData::WebUI_zipSize, false};
-        juce::ZipFile zipFile {zipStream};
-
-        const auto* zipEntry = zipFile.getEntry(filepath);
-
-        if (zipEntry == nullptr)
-        {
-            juce::Logger::writeToLog("Resource Provider Internal: FAILED to find file: '" + filepath + "'");
-            return {};
-        }
-
-        const std::unique_ptr<juce::InputStream> entryStream {zipFile.createStreamForEntry(*zipEntry)};
-        if (entryStream == nullptr)
-        {
-            juce::Logger::writeToLog("Resource Provider Internal: FAILED to create stream for file: '" + filepath +
-                                     "'");
-            return {};
-        }
-
-        return WebUtils::streamToVector(*entryStream);
-    }
-    static inline std::optional<Resource> getStaticFileResource(const juce::String& filepath)
-    {
-        juce::MemoryInputStream zipStream {BinaryData::WebUI_zip, BinaryData::WebUI_zipSize, false};
-        juce::ZipFile zipFile {zipStream};
-
-        if (const auto* zipEntry = zipFile.getEntry(filepath))
-        {
-            if (const std::unique_ptr<juce::InputStream> entryStream {zipFile.createStreamForEntry(*zipEntry)})
-            {
-                std::vector<std::byte> resourceBytes((size_t) entryStream->getTotalLength());
-                entryStream->read(resourceBytes.data(), resourceBytes.size());
-
-                const auto extension = filepath.fromLastOccurrenceOf(".", false, false);
-                return Resource {std::move(resourceBytes), getMimeForExtension(extension)};
-            }
-        }
-        
         return std::nullopt;
     }
 }
 
 
-static inline std::optional<Resource> getWebResource(const juce::String& url, const DynamicResourceProvider& dynamicResourceProvider)
+/** The requested path with its query, as a view into the URL; the root resolves to index.html. */
+static inline std::string_view getResourcePath(const juce::String& url)
 {
-    const auto resourceToRetrieve = (url == "/") ? "index.html" : url.fromFirstOccurrenceOf("/", false, false);
+    std::string_view resourceToRetrieve {url.toRawUTF8()};
+    resourceToRetrieve.remove_prefix(juce::jmin(resourceToRetrieve.find('/') + 1, resourceToRetrieve.size()));
 
-    if (auto dynamicResource = dynamicResourceProvider.handleRequest(resourceToRetrieve))
-        return dynamicResource;
+    if (resourceToRetrieve.empty())
+        resourceToRetrieve = "index.html";
+
+    return resourceToRetrieve;
+}
 
-    if (auto staticResource = getStaticFileResource(resourceToRetrieve))
+/** True if the URL asks for the page itself, i.e. the Web UI is being loaded or reloaded. */
+static inline bool isPageRequest(const juce::String& url)
+{
+    const auto path = getResourcePath(url);
+    return path.substr(0, path.find('?')) == "index.html";
+}
+
+static inline std::optional<Resource> getWebResource(const juce::String& url,
+                                                     const DynamicResourceProvider& dynamicResourceProvider,
+                                                     WebAssetCache& assetCache)
+{
+    // Resolve the path as a view into the URL, so static assets are served without building strings.
+    const auto resourceToRetrieve = getResourcePath(url);
+
+    // Static assets are looked up without any query string; dynamic endpoints may read it.
+    if (auto staticResource = getStaticFileResource(resourceToRetrieve.substr(0, resourceToRetrieve.find('?')), assetCache))
         return staticResource;
-    
-    juce::Logger::writeToLog("Resource not found: " + resourceToRetrieve);
+
+    const juce::String resourceName {resourceToRetrieve.data(), resourceToRetrieve.size()};
+
+    if (auto dynamicResource = dynamicResourceProvider.handleRequest(resourceName))
+        return dynamicResource;
+
+    juce::Logger::writeToLog("Resource not found: " + resourceName);
     return std::nullopt;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include <unordered_map>
 #include <vector>
 
 namespace WebUtils
@@ -22,4 +23,48 @@ namespace WebUtils
 
         return result;
     }
+
+    static const std::unordered_map<juce::String, const char*> mimeMap = {{{"htm"}, "text/html"},
+                                                                          {{"html"}, "text/html"},
+                                                                          {{"txt"}, "text/plain"},
+                                                                          {{"jpg"}, "image/jpeg"},
+                                                                          {{"jpeg"}, "image/jpeg"},
+                                                                          {{"svg"}, "image/svg+xml"},
+                                                                          {{"ico"}, "image/vnd.microsoft.icon"},
+                                                                          {{"json"}, "application/json"},
+                                                                          {{"png"}, "image/png"},
+                                                                          {{"css"}, "text/css"},
+                                                                          {{"map"}, "application/json"},
+                                                                          {{"js"}, "text/javascript"},
+                                                                          {{"woff2"}, "font/woff2"}};
+
+    /** The type served for assets whose extension is not in mimeMap. */
+    static constexpr const char* fallbackMimeType = "application/octet-stream";
+
+    /**
+     * @brief Looks up the MIME type for a file extension without asserting.
+     * @param extension The extension without the leading dot; matched case-insensitively.
+     * @return The MIME type, or nullptr for unknown extensions.
+     */
+    static inline const char* findMimeForExtension(const juce::String& extension)
+    {
+        if (const auto it = mimeMap.find(extension.toLowerCase()); it != mimeMap.end())
+            return it->second;
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Looks up the MIME type for a file extension, e.g. "js" -> "text/javascript".
+     * @param extension The extension without the leading dot; matched case-insensitively.
+     * @return The MIME type, or an empty string for unknown extensions.
+     */
+    static inline const char* getMimeForExtension(const juce::String& extension)
+    {
+        if (const auto* mimeType = findMimeForExtension(extension))
+            return mimeType;
+
+        jassertfalse;
+        return "";
+    }
 }
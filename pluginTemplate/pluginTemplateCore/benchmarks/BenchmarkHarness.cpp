@@ -0,0 +1,165 @@
+#include "BenchmarkHarness.h"
+
+#include <chrono>
+#include <limits>
+#include <map>
+
+juce::String Benchmarks::toString(SignalType signal)
+{
+    switch (signal)
+    {
+        case SignalType::silence:   return "silence";
+        case SignalType::denormals: return "denormals";
+        case SignalType::noise:     return "noise";
+    }
+
+    jassertfalse;
+    return {};
+}
+
+juce::String Benchmarks::Case::getKey() const
+{
+    return benchmark + "/" + juce::String(blockSize) + "/" + juce::String(numChannels) + "/" + toString(signal);
+}
+
+void Benchmarks::fillSignal(juce::AudioBuffer<float>& buffer, SignalType signal, juce::Random& random)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getWritePointer(channel);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            switch (signal)
+            {
+                case SignalType::silence:   data[i] = 0.0f; break;
+                case SignalType::denormals: data[i] = std::numeric_limits<float>::denorm_min() * (float) (1 + (i & 0xff)); break;
+                case SignalType::noise:     data[i] = random.nextFloat() * 2.0f - 1.0f; break;
+            }
+        }
+    }
+}
+
+std::vector<Benchmarks::Result> Benchmarks::run(const Benchmark& benchmark, const RunOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Result> results;
+    juce::Random random {0x5eed};
+
+    for (const auto signal : benchmark.signals)
+    {
+        for (const auto numChannels : benchmark.channelCounts)
+        {
+            for (const auto blockSize : benchmark.blockSizes)
+            {
+                const Case benchmarkCase {benchmark.name, blockSize, numChannels, signal};
+
+                if (options.filter.isNotEmpty() && ! benchmarkCase.getKey().contains(options.filter))
+                    continue;
+
+                juce::AudioBuffer<float> buffer {numChannels, blockSize};
+                fillSignal(buffer, signal, random);
+
+                auto processBlock = benchmark.factory(benchmarkCase, options.sampleRate);
+                const auto iterations = juce::jmax((juce::int64) 1, options.samplesPerMeasurement / blockSize);
+
+                // Denormal handling mirrors processBlock, which runs under ScopedNoDenormals.
+                std::unique_ptr<juce::ScopedNoDenormals> noDenormals;
+                if (options.flushDenormals)
+                    noDenormals = std::make_unique<juce::ScopedNoDenormals>();
+
+                for (juce::int64 i = 0; i < juce::jmin(iterations, (juce::int64) 64); ++i)
+                    processBlock(buffer);
+
+                auto fastest = std::numeric_limits<double>::max();
+
+                for (int measurement = 0; measurement < options.numMeasurements; ++measurement)
+                {
+                    const auto start = Clock::now();
+
+                    for (juce::int64 i = 0; i < iterations; ++i)
+                        processBlock(buffer);
+
+                    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                    fastest = juce::jmin(fastest, elapsed);
+                }
+
+                const auto totalSamples = (double) iterations * blockSize * numChannels;
+                const auto nsPerSample = fastest / totalSamples;
+                results.push_back({benchmarkCase, nsPerSample, 1.0e9 / nsPerSample, iterations});
+            }
+        }
+    }
+
+    return results;
+}
+
+juce::String Benchmarks::toCsv(const std::vector<Result>& results)
+{
+    juce::String csv {"benchmark,blockSize,numChannels,signal,nsPerSample,samplesPerSecond,iterations\n"};
+
+    for (const auto& result : results)
+    {
+        const auto& c = result.benchmarkCase;
+        csv << c.benchmark << "," << c.blockSize << "," << c.numChannels << "," << toString(c.signal) << ","
+            << juce::String(result.nsPerSample, 4) << "," << juce::String(result.samplesPerSecond, 0) << ","
+            << result.iterations << "\n";
+    }
+
+    return csv;
+}
+
+juce::String Benchmarks::toJson(const std::vector<Result>& results)
+{
+    juce::Array<juce::var> entries;
+
+    for (const auto& result : results)
+    {
+        const auto& c = result.benchmarkCase;
+        juce::DynamicObject::Ptr entry {new juce::DynamicObject{}};
+        entry->setProperty("benchmark", c.benchmark);
+        entry->setProperty("blockSize", c.blockSize);
+        entry->setProperty("numChannels", c.numChannels);
+        entry->setProperty("signal", toString(c.signal));
+        entry->setProperty("nsPerSample", result.nsPerSample);
+        entry->setProperty("samplesPerSecond", result.samplesPerSecond);
+        entry->setProperty("iterations", result.iterations);
+        entries.add(entry.get());
+    }
+
+    return juce::JSON::toString(entries);
+}
+
+juce::StringArray Benchmarks::findRegressions(const std::vector<Result>& results, const juce::String& baselineCsv,
+                                              double thresholdPercent)
+{
+    std::map<juce::String, double> baseline;
+
+    for (const auto& line : juce::StringArray::fromLines(baselineCsv))
+    {
+        const auto fields = juce::StringArray::fromTokens(line, ",", {});
+        if (fields.size() < 5 || ! fields[1].containsOnly("0123456789"))
+            continue; // header or malformed line
+
+        baseline[fields[0] + "/" + fields[1] + "/" + fields[2] + "/" + fields[3]] = fields[4].getDoubleValue();
+    }
+
+    juce::StringArray regressions;
+
+    for (const auto& result : results)
+    {
+        const auto key = result.benchmarkCase.getKey();
+
+        if (const auto it = baseline.find(key); it != baseline.end() && it->second > 0.0)
+        {
+            const auto changePercent = (result.nsPerSample / it->second - 1.0) * 100.0;
+
+            if (changePercent > thresholdPercent)
+                regressions.add(key + ": " + juce::String(it->second, 4) + " -> " + juce::String(result.nsPerSample, 4)
+                                + " ns/sample (+" + juce::String(changePercent, 1) + "%)");
+        }
+    }
+
+    return regressions;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <functional>
+#include <vector>
+
+/**
+ * @namespace Benchmarks
+ * @brief A small offline microbenchmark harness for the pluginTemplateCore hot paths.
+ *
+ * Every benchmark is registered as a function that prepares the code under
+ * test for a given Case and returns the per-block work to be timed. The
+ * runner feeds that work with blocks of the requested signal type and reports
+ * nanoseconds per channel-sample and channel-samples per second.
+ */
+namespace Benchmarks
+{
+    enum class SignalType
+    {
+        silence,
+        denormals,
+        noise
+    };
+
+    juce::String toString(SignalType);
+
+    struct Case
+    {
+        juce::String benchmark;
+        int blockSize = 0;
+        int numChannels = 0;
+        SignalType signal = SignalType::silence;
+
+        /** A stable identifier used to match results against a baseline. */
+        [[nodiscard]] juce::String getKey() const;
+    };
+
+    struct Result
+    {
+        Case benchmarkCase;
+        double nsPerSample = 0.0;
+        double samplesPerSecond = 0.0;
+        juce::int64 iterations = 0;
+    };
+
+    /** The per-block work of a benchmark, called repeatedly on the same buffer. */
+    using BlockFunction = std::function<void(juce::AudioBuffer<float>&)>;
+
+    /** Creates the per-block work for a case; called once before timing starts. */
+    using Factory = std::function<BlockFunction(const Case&, double sampleRate)>;
+
+    struct Benchmark
+    {
+        juce::String name;
+        Factory factory;
+        std::vector<int> blockSizes;
+        std::vector<int> channelCounts;
+        std::vector<SignalType> signals;
+    };
+
+    /** Fills every channel of the buffer with the given signal. */
+    void fillSignal(juce::AudioBuffer<float>& buffer, SignalType signal, juce::Random& random);
+
+    struct RunOptions
+    {
+        double sampleRate = 48000.0;
+        juce::int64 samplesPerMeasurement = 1 << 18;
+        int numMeasurements = 5;
+        bool flushDenormals = true;
+        juce::String filter;
+    };
+
+    /**
+     * Runs every case of a benchmark and returns one result per case. Each case
+     * is measured numMeasurements times and the fastest measurement is kept to
+     * suppress scheduling noise.
+     */
+    std::vector<Result> run(const Benchmark& benchmark, const RunOptions& options);
+
+    juce::String toCsv(const std::vector<Result>& results);
+    juce::String toJson(const std::vector<Result>& results);
+
+    /**
+     * Compares results against a CSV written by an earlier run and returns the
+     * keys of all cases that got slower by more than thresholdPercent.
+     */
+    juce::StringArray findRegressions(const std::vector<Result>& results, const juce::String& baselineCsv,
+                                      double thresholdPercent);
+}
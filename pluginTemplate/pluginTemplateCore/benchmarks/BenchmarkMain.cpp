@@ -0,0 +1,76 @@
+#include "BenchmarkHarness.h"
+#include "CoreBenchmarks.h"
+
+#include <iostream>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: pluginTemplateCoreBenchmarks [options]\n"
+                     "  --filter <text>          only run cases whose key contains <text>\n"
+                     "  --format <csv|json>      output format (default: csv)\n"
+                     "  --output <file>          write results to <file> instead of stdout\n"
+                     "  --baseline <file>        compare against a CSV written by an earlier run\n"
+                     "  --threshold <percent>    allowed slowdown against the baseline (default: 5)\n"
+                     "  --samples <count>        channel-samples per measurement (default: 262144)\n"
+                     "  --keep-denormals         do not flush denormals while measuring\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments {argc, argv};
+
+    if (arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Benchmarks::RunOptions options;
+    options.filter = arguments.getValueForOption("--filter");
+    options.flushDenormals = ! arguments.containsOption("--keep-denormals");
+
+    if (const auto samples = arguments.getValueForOption("--samples"); samples.isNotEmpty())
+        options.samplesPerMeasurement = juce::jmax((juce::int64) 1, samples.getLargeIntValue());
+
+    std::vector<Benchmarks::Result> results;
+
+    for (const auto& benchmark : Benchmarks::createCoreBenchmarks())
+    {
+        const auto benchmarkResults = Benchmarks::run(benchmark, options);
+        results.insert(results.end(), benchmarkResults.begin(), benchmarkResults.end());
+    }
+
+    const auto output = arguments.getValueForOption("--format") == "json" ? Benchmarks::toJson(results)
+                                                                          : Benchmarks::toCsv(results);
+
+    if (const auto outputPath = arguments.getValueForOption("--output"); outputPath.isNotEmpty())
+        juce::File::getCurrentWorkingDirectory().getChildFile(outputPath).replaceWithText(output);
+    else
+        std::cout << output << std::endl;
+
+    if (const auto baselinePath = arguments.getValueForOption("--baseline"); baselinePath.isNotEmpty())
+    {
+        const auto baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(baselinePath);
+
+        if (! baselineFile.existsAsFile())
+        {
+            std::cerr << "Baseline not found: " << baselineFile.getFullPathName() << std::endl;
+            return 2;
+        }
+
+        const auto thresholdOption = arguments.getValueForOption("--threshold");
+        const auto thresholdPercent = thresholdOption.isNotEmpty() ? thresholdOption.getDoubleValue() : 5.0;
+        const auto regressions = Benchmarks::findRegressions(results, baselineFile.loadFileAsString(), thresholdPercent);
+
+        for (const auto& regression : regressions)
+            std::cerr << "REGRESSION " << regression << std::endl;
+
+        if (! regressions.isEmpty())
+            return 1;
+    }
+
+    return 0;
+}
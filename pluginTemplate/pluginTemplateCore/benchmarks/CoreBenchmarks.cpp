@@ -0,0 +1,250 @@
+#include "CoreBenchmarks.h"
+
+#include <pluginTemplateCore/DspProcessor.h>
+#include <pluginTemplateCore/LoudnessMeter.h>
+#include <pluginTemplateCore/Oversampler.h>
+#include <pluginTemplateCore/PeakLevelMeter.h>
+#include <pluginTemplateCore/ProcessingChain.h>
+#include <pluginTemplateCore/SubBlockScheduler.h>
+
+#include <type_traits>
+
+namespace
+{
+    const std::vector<int> blockSizes {1, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
+    const std::vector<int> channelCounts {1, 2, 6, 8, 12, 16};
+    const std::vector<Benchmarks::SignalType> signals {Benchmarks::SignalType::silence,
+                                                       Benchmarks::SignalType::denormals,
+                                                       Benchmarks::SignalType::noise};
+
+    juce::dsp::ProcessSpec makeSpec(const Benchmarks::Case& benchmarkCase, double sampleRate)
+    {
+        return {sampleRate, (juce::uint32) benchmarkCase.blockSize, (juce::uint32) benchmarkCase.numChannels};
+    }
+
+    Benchmarks::Benchmark makeBenchmark(const juce::String& name, Benchmarks::Factory factory)
+    {
+        return {name, std::move(factory), blockSizes, channelCounts, signals};
+    }
+
+    /**
+     * Adapts work on SampleType buffers to the harness, which fills float
+     * buffers. Double precision work runs on its own copy of the signal,
+     * converted during the first, untimed warm-up call.
+     */
+    template <typename SampleType, typename Work>
+    Benchmarks::BlockFunction inPrecision(Work work)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            return work;
+        }
+        else
+        {
+            return [work, converted = std::make_shared<juce::AudioBuffer<SampleType>>()](juce::AudioBuffer<float>& buffer) mutable
+            {
+                if (converted->getNumSamples() != buffer.getNumSamples())
+                    converted->makeCopyOf(buffer);
+
+                work(*converted);
+            };
+        }
+    }
+
+    /** DspProcessor and PeakLevelMeter; double precision cases get a ".double" suffix. */
+    template <typename SampleType>
+    void addGainAndMeterBenchmarks(std::vector<Benchmarks::Benchmark>& benchmarks)
+    {
+        const juce::String suffix = std::is_same_v<SampleType, double> ? ".double" : "";
+
+        // Alternates between two reciprocal gains so the signal level stays bounded.
+        // With a one sample ramp almost every sample takes the settled, constant gain path.
+        benchmarks.push_back(makeBenchmark("DspProcessor.settled" + suffix, [](const Benchmarks::Case& c, double sampleRate)
+        {
+            auto processor = std::make_shared<DspProcessor<SampleType>>();
+            processor->prepare(makeSpec(c, sampleRate), (float) (1000.0 / sampleRate));
+
+            return inPrecision<SampleType>([processor, flip = false](juce::AudioBuffer<SampleType>& buffer) mutable
+            {
+                processor->process(buffer, (flip = ! flip) ? SampleType(0.5) : SampleType(2));
+            });
+        }));
+
+        // The same, split by forEachSubBlock() the way the plugin runs it: 32 sample
+        // sub-blocks on the unrolled kernels plus a runtime length tail.
+        benchmarks.push_back(makeBenchmark("DspProcessor.subBlocks" + suffix, [](const Benchmarks::Case& c, double sampleRate)
+        {
+            auto processor = std::make_shared<DspProcessor<SampleType>>();
+            processor->prepare(makeSpec(c, sampleRate), (float) (1000.0 / sampleRate));
+
+            return inPrecision<SampleType>([processor, flip = false](juce::AudioBuffer<SampleType>& buffer) mutable
+            {
+                using Block = juce::dsp::AudioBlock<SampleType>;
+                const auto gain = (flip = ! flip) ? SampleType(0.5) : SampleType(2);
+
+                forEachSubBlock<32>(Block(buffer),
+                    [&](const Block& subBlock) { processor->template processFixed<32>(subBlock, gain); },
+                    [&](const Block& tail) { processor->process(tail, gain); });
+            });
+        }));
+
+        // A ramp longer than any block keeps every sample on the ramp kernels.
+        benchmarks.push_back(makeBenchmark("DspProcessor.ramping" + suffix, [](const Benchmarks::Case& c, double sampleRate)
+        {
+            auto processor = std::make_shared<DspProcessor<SampleType>>();
+            processor->prepare(makeSpec(c, sampleRate), (float) (1000.0 * 2 * c.blockSize / sampleRate));
+
+            return inPrecision<SampleType>([processor, flip = false](juce::AudioBuffer<SampleType>& buffer) mutable
+            {
+                processor->process(buffer, (flip = ! flip) ? SampleType(0.5) : SampleType(2));
+            });
+        }));
+
+        benchmarks.push_back(makeBenchmark("PeakLevelMeter" + suffix, [](const Benchmarks::Case& c, double sampleRate)
+        {
+            auto meter = std::make_shared<PeakLevelMeter>();
+            meter->prepare(makeSpec(c, sampleRate));
+
+            return inPrecision<SampleType>([meter](juce::AudioBuffer<SampleType>& buffer) { meter->process(buffer); });
+        }));
+    }
+
+    /**
+     * Up- and downsampling with nothing in between, once with the Oversampler
+     * and once with juce::dsp::Oversampling configured the same way. The
+     * filters are content independent, so noise is the only signal measured.
+     */
+    void addOversamplingBenchmarks(std::vector<Benchmarks::Benchmark>& benchmarks)
+    {
+        using JuceOversampling = juce::dsp::Oversampling<float>;
+
+        const std::vector<int> oversamplingBlockSizes {32, 128, 512, 2048};
+        const std::vector<int> oversamplingChannelCounts {1, 2, 8};
+
+        struct Design
+        {
+            const char* name;
+            Oversampler::FilterType filterType;
+            JuceOversampling::FilterType juceFilterType;
+        };
+
+        const Design designs[] {
+            {"fir", Oversampler::FilterType::firHalfBand, JuceOversampling::filterHalfBandFIREquiripple},
+            {"iir", Oversampler::FilterType::iirHalfBandPolyphase, JuceOversampling::filterHalfBandPolyphaseIIR}
+        };
+
+        for (const auto& design : designs)
+        {
+            for (int factorLog2 = 1; factorLog2 <= Oversampler::maxFactorLog2; ++factorLog2)
+            {
+                const auto suffix = juce::String(".") + design.name + "." + juce::String(1 << factorLog2) + "x";
+
+                benchmarks.push_back({"Oversampler" + suffix,
+                    [design, factorLog2](const Benchmarks::Case& c, double sampleRate) -> Benchmarks::BlockFunction
+                    {
+                        auto oversampler = std::make_shared<Oversampler>();
+                        oversampler->prepare(makeSpec(c, sampleRate), design.filterType);
+                        oversampler->setFactorLog2(factorLog2);
+
+                        return [oversampler](juce::AudioBuffer<float>& buffer)
+                        {
+                            juce::dsp::AudioBlock<float> block (buffer);
+                            oversampler->processSamplesUp(block);
+                            oversampler->processSamplesDown(block);
+                        };
+                    },
+                    oversamplingBlockSizes, oversamplingChannelCounts, {Benchmarks::SignalType::noise}});
+
+                benchmarks.push_back({"juce::dsp::Oversampling" + suffix,
+                    [design, factorLog2](const Benchmarks::Case& c, double) -> Benchmarks::BlockFunction
+                    {
+                        auto oversampling = std::make_shared<JuceOversampling>(
+                            (size_t) c.numChannels, (size_t) factorLog2, design.juceFilterType);
+                        oversampling->initProcessing((size_t) c.blockSize);
+
+                        return [oversampling](juce::AudioBuffer<float>& buffer)
+                        {
+                            juce::dsp::AudioBlock<float> block (buffer);
+                            oversampling->processSamplesUp(block);
+                            oversampling->processSamplesDown(block);
+                        };
+                    },
+                    oversamplingBlockSizes, oversamplingChannelCounts, {Benchmarks::SignalType::noise}});
+            }
+        }
+    }
+
+    /**
+     * Input meter, gain, output meter and loudness meter, once as a pass over
+     * the whole block per stage and once fused into a ProcessingChain. Only
+     * blocks that outgrow the caches, as in an offline bounce, are expected to
+     * show a difference.
+     */
+    void addProcessingChainBenchmarks(std::vector<Benchmarks::Benchmark>& benchmarks)
+    {
+        const std::vector<int> chainBlockSizes {512, 2048, 8192, 32768};
+        const std::vector<int> chainChannelCounts {2, 8, 16};
+
+        struct Stages
+        {
+            explicit Stages(const juce::dsp::ProcessSpec& spec)
+            {
+                inputMeter.prepare(spec);
+                gain.prepare(spec, 1.0f);
+                outputMeter.prepare(spec);
+                loudnessMeter.prepare(spec);
+            }
+
+            PeakLevelMeter inputMeter;
+            DspProcessor<float> gain;
+            PeakLevelMeter outputMeter;
+            LoudnessMeter loudnessMeter;
+            bool flip = false;
+        };
+
+        benchmarks.push_back({"ProcessingChain.separate", [](const Benchmarks::Case& c, double sampleRate) -> Benchmarks::BlockFunction
+        {
+            auto stages = std::make_shared<Stages>(makeSpec(c, sampleRate));
+
+            return [stages](juce::AudioBuffer<float>& buffer)
+            {
+                stages->inputMeter.process(buffer);
+                stages->gain.process(buffer, (stages->flip = ! stages->flip) ? 0.5f : 2.0f);
+                stages->outputMeter.process(buffer);
+                stages->loudnessMeter.process(buffer);
+            };
+        },
+        chainBlockSizes, chainChannelCounts, {Benchmarks::SignalType::noise}});
+
+        benchmarks.push_back({"ProcessingChain.fused", [](const Benchmarks::Case& c, double sampleRate) -> Benchmarks::BlockFunction
+        {
+            auto stages = std::make_shared<Stages>(makeSpec(c, sampleRate));
+
+            return [stages](juce::AudioBuffer<float>& buffer)
+            {
+                const auto gain = (stages->flip = ! stages->flip) ? 0.5f : 2.0f;
+
+                auto chain = makeProcessingChain(getProcessingTileLength((size_t) buffer.getNumChannels()),
+                    [&](const juce::dsp::AudioBlock<float>& tile) { stages->inputMeter.process(tile); },
+                    [&](const juce::dsp::AudioBlock<float>& tile) { stages->gain.process(tile, gain); },
+                    [&](const juce::dsp::AudioBlock<float>& tile) { stages->outputMeter.process(tile); },
+                    [&](const juce::dsp::AudioBlock<float>& tile) { stages->loudnessMeter.process(tile); });
+
+                chain.process(juce::dsp::AudioBlock<float>(buffer));
+            };
+        },
+        chainBlockSizes, chainChannelCounts, {Benchmarks::SignalType::noise}});
+    }
+}
+
+std::vector<Benchmarks::Benchmark> Benchmarks::createCoreBenchmarks()
+{
+    std::vector<Benchmark> benchmarks;
+
+    addGainAndMeterBenchmarks<float>(benchmarks);
+    addGainAndMeterBenchmarks<double>(benchmarks);
+    addOversamplingBenchmarks(benchmarks);
+    addProcessingChainBenchmarks(benchmarks);
+
+    return benchmarks;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "BenchmarkHarness.h"
+
+namespace Benchmarks
+{
+    /** The benchmarks covering DspProcessor, PeakLevelMeter, Oversampler and ProcessingChain. */
+    std::vector<Benchmark> createCoreBenchmarks();
+}
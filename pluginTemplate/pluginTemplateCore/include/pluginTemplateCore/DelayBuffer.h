@@ -0,0 +1,47 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <vector>
+
+/**
+ * @class DelayBuffer
+ * @brief Keeps the most recent samples of a signal, to replay them delayed by a whole number of samples.
+ *
+ * One ring per channel, large enough for the longest delay plus one block.
+ * Samples are written and read in at most two contiguous segments per
+ * channel, so pushing costs a copy whatever the delay. Nothing allocates
+ * after prepare().
+ *
+ * SampleType is float or double, both instantiated in DelayBuffer.cpp.
+ */
+template <typename SampleType>
+class DelayBuffer
+{
+public:
+    /** Allocates. maxDelaySamples bounds the delay passed to process(). */
+    void prepare(const juce::dsp::ProcessSpec& spec, int maxDelaySamples);
+
+    /** Fills the history with silence. */
+    void reset() noexcept;
+
+    /** Appends the block to the history. Only the most recent samples are kept. */
+    void push(const juce::dsp::AudioBlock<const SampleType>& block) noexcept;
+
+    /** Appends the block to the history and replaces it with the samples delaySamples earlier. */
+    void process(const juce::dsp::AudioBlock<SampleType>& block, int delaySamples) noexcept;
+
+    /** Copies the most recent destination.getNumSamples() samples, at most maxDelaySamples, into destination. */
+    void copyLatest(const juce::dsp::AudioBlock<SampleType>& destination) const noexcept;
+
+private:
+    void copyFromRing(const juce::dsp::AudioBlock<SampleType>& destination, int startPosition) const noexcept;
+
+    int numChannels = 0;
+    int maxDelay = 0;
+    int capacity = 0;          // maxDelay plus the prepared maximum block size.
+    int writePosition = 0;
+
+    std::vector<SampleType> rings;  // numChannels rings of capacity samples.
+};
@@ -1,7 +1,81 @@
+#pragma once
+
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
 
+/**
+ * @class DspProcessor
+ * @brief Applies the plugin's gain with click-free transitions between values.
+ *
+ * Whenever the requested gain changes, the processor ramps from the gain it
+ * applied last to the new one over a fixed time instead of jumping, which
+ * removes zipper noise under automation. Once a ramp has settled the block is
+ * processed by a plain vectorized multiply.
+ *
+ * Every channel gets the same gain, so with more than one channel the ramp is
+ * written once into a gain curve and all channels are multiplied by it. The
+ * per-channel cost is then a single vectorized multiply, whatever the layout
+ * (up to 7.1.4 or third order ambisonics in the plugin).
+ *
+ * processFixed() is the same for a sub-block whose length is a template
+ * argument, see forEachSubBlock(): settled gains and ramps that cover the
+ * whole sub-block go through the unrolled FixedSizeKernels.
+ *
+ * SampleType is float or double; both are instantiated in DspProcessor.cpp.
+ * The double version keeps its gains and ramps in double precision too, so a
+ * 64-bit host path stays 64-bit throughout.
+ * This implementation is real-time safe.
+ */
+template <typename SampleType>
 class DspProcessor
 {
 public:
-    void process(juce::AudioBuffer<float>& buffer, float gainToApply);
+    enum class RampShape
+    {
+        linear,         // Constant change in amplitude per sample.
+        multiplicative  // Constant change in dB per sample.
+    };
+
+    void prepare(const juce::dsp::ProcessSpec& spec, float rampTimeMs = 20.0f,
+                 RampShape shape = RampShape::multiplicative);
+
+    void process(juce::AudioBuffer<SampleType>& buffer, SampleType gainToApply);
+
+    /** The same as above for a block, e.g. the oversampled block handed out by an Oversampler. */
+    void process(const juce::dsp::AudioBlock<SampleType>& block, SampleType gainToApply);
+
+    /**
+     * The same for a block of exactly numSamples samples, with kernels unrolled
+     * for that length. Instantiated for 32 and 64 samples. Can be mixed freely
+     * with process(), which a forEachSubBlock() tail would use.
+     */
+    template <int numSamples>
+    void processFixed(const juce::dsp::AudioBlock<SampleType>& block, SampleType gainToApply);
+
+    /** Drops any ramp in progress; the next processed block starts at its requested gain. */
+    void reset();
+
+    [[nodiscard]] bool isRamping() const noexcept { return samplesUntilTarget > 0; }
+
+private:
+    void updateTarget(SampleType gainToApply);
+    void startRamp(SampleType newTargetGain);
+    void applyGain(const juce::dsp::AudioBlock<SampleType>& block);
+    SampleType applyRamp(const juce::dsp::AudioBlock<SampleType>& block, int numRampSamples);
+
+    RampShape rampShape = RampShape::multiplicative;
+    int rampLengthSamples = 0;
+
+    SampleType currentGain = 1;
+    SampleType targetGain = 1;
+    SampleType rampStep = 0;
+    bool rampIsMultiplicative = false;
+    int samplesUntilTarget = 0;
+    bool snapToNextGain = true;
+
+    // Shared ramp for multichannel blocks, filled one chunk at a time. Fixed
+    // size, so prepare() can run on the audio thread when the rate changes.
+    std::array<SampleType, 256> gainCurve {};
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * @namespace FixedSizeKernels
+ * @brief Kernels for a length known at compile time, as handed out by forEachSubBlock().
+ *
+ * With the length a template argument, every kernel is a fixed number of
+ * SIMD register operations that is expanded at compile time, so there is no
+ * loop, no runtime trip count and no scalar remainder. Loads and stores are
+ * unaligned, because sub-blocks start wherever the host buffer puts them.
+ *
+ * Every kernel is instantiated for float and double at 32 and 64 samples,
+ * see FixedSizeKernels.cpp.
+ */
+namespace FixedSizeKernels
+{
+    /** Multiplies numSamples samples by a constant gain. */
+    template <int numSamples, typename SampleType>
+    void multiply(SampleType* data, SampleType gain) noexcept;
+
+    /** Multiplies numSamples samples by the gains at the same positions, e.g. a ramp curve. */
+    template <int numSamples, typename SampleType>
+    void multiply(SampleType* data, const SampleType* gains) noexcept;
+
+    /** The largest absolute value among numSamples samples. */
+    template <int numSamples, typename SampleType>
+    [[nodiscard]] SampleType findMagnitude(const SampleType* data) noexcept;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * @namespace GainKernels
+ * @brief Vectorized in-place gain kernels used by the DspProcessor.
+ *
+ * The ramp kernels run a scalar head until the data is SIMD aligned, then
+ * process one juce::dsp::SIMDRegister per iteration with every lane carrying
+ * its own gain value, and finish with a scalar tail. All kernels return the
+ * gain that would be applied to the sample following the processed range, so
+ * a ramp can be continued seamlessly across blocks.
+ *
+ * Every kernel is instantiated for float and double; double data runs on
+ * SIMDRegister<double>, with half as many lanes per register.
+ */
+namespace GainKernels
+{
+    /** Multiplies the data by a constant gain, with shortcuts for unity and silence. */
+    template <typename SampleType>
+    void applyConstant(SampleType* data, int numSamples, SampleType gain) noexcept;
+
+    /** Applies gain, gain + increment, gain + 2 * increment, ... to consecutive samples. */
+    template <typename SampleType>
+    SampleType applyLinearRamp(SampleType* data, int numSamples, SampleType startGain, SampleType increment) noexcept;
+
+    /** Applies gain, gain * ratio, gain * ratio^2, ... to consecutive samples. */
+    template <typename SampleType>
+    SampleType applyMultiplicativeRamp(SampleType* data, int numSamples, SampleType startGain, SampleType ratio) noexcept;
+
+    /** Writes the gains applyLinearRamp() would apply, so one curve can be shared by many channels. */
+    template <typename SampleType>
+    SampleType fillLinearRamp(SampleType* destination, int numSamples, SampleType startGain, SampleType increment) noexcept;
+
+    /** Writes the gains applyMultiplicativeRamp() would apply. */
+    template <typename SampleType>
+    SampleType fillMultiplicativeRamp(SampleType* destination, int numSamples, SampleType startGain, SampleType ratio) noexcept;
+}
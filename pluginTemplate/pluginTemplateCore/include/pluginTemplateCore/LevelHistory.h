@@ -0,0 +1,109 @@
+#pragma once
+
+#include "pluginTemplateCore/MeterTelemetry.h"
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @class LevelHistory
+ * @brief Scrolling min/max history of the meter readings, from seconds up to days.
+ *
+ * The audio thread feeds one MeterFrame per block. The readings are reduced
+ * to a minimum and a maximum per point of pointSeconds, and every pair of
+ * points at one level of detail is merged into a point of the next, so level
+ * k holds one point per pointSeconds * 2^k. Each level is a ring of capacity
+ * points, i.e. memory is fixed and level k reaches back capacity points at
+ * its own resolution: about 50 s at level 0 and over a day at the top.
+ * Writing costs O(1) amortized per point, because each level above receives
+ * half as many points as the one below.
+ *
+ * Readings are stored in hundredths of a dB as 16-bit integers, the minima
+ * and the maxima of a point packed into one 64-bit word each, which is far
+ * finer than a history view can show and keeps all levels under 300 kB.
+ *
+ * Points are numbered per level from the first point ever written; the
+ * numbers keep counting across prepare(), so readers can ask for the points
+ * after the last one they have (copyPoints()) and never receive one twice.
+ * Time during which the host did not process is not represented.
+ *
+ * Readers on any thread read a slot's values between two loads of a sequence
+ * stamp that the writer sets before and after writing it. Torn or overwritten
+ * slots are detected and left out, so the audio thread never waits.
+ */
+class LevelHistory
+{
+public:
+    enum Quantity
+    {
+        inputPeak,          // dB, loudest channel
+        outputPeak,         // dB, loudest channel
+        momentaryLoudness,  // LUFS
+        shortTermLoudness,  // LUFS
+        numQuantities
+    };
+
+    static constexpr int numLevels = 12;
+    static constexpr int capacity = 1024;           // Points per level; a power of two.
+    static constexpr double pointSeconds = 0.05;    // Resolution of level 0.
+
+    struct Point
+    {
+        std::array<float, numQuantities> minimum {};
+        std::array<float, numQuantities> maximum {};
+    };
+
+    /** Allocates all levels, so nothing is allocated while readers may be reading. */
+    LevelHistory();
+
+    /** Restarts the current point at the new rate. The history itself is kept. */
+    void prepare(double sampleRate) noexcept;
+
+    /** Audio thread. Adds the readings of a block of numSamples samples. */
+    void push(const MeterFrame& frame, int numSamples) noexcept;
+
+    /** Any thread. The number of the next point to be written at a level, i.e. of all written so far. */
+    [[nodiscard]] juce::uint64 getNumPoints(int level) const noexcept;
+
+    /**
+     * Any thread. Copies up to maxPoints consecutive points of a level,
+     * starting with point number since or, if that has already been
+     * overwritten, with the oldest one still held. Returns how many were
+     * copied and sets firstIndex to the number of the first one.
+     */
+    int copyPoints(int level, juce::uint64 since, Point* destination, int maxPoints, juce::uint64& firstIndex) const noexcept;
+
+    [[nodiscard]] static double getPointSeconds(int level) noexcept { return pointSeconds * (double) (1 << level); }
+
+private:
+    struct Slot
+    {
+        // 2 * index + 1 while point index is written, 2 * index + 2 once it is complete.
+        std::atomic<juce::uint64> stamp {0};
+        std::atomic<juce::uint64> minimum {0};  // See pack().
+        std::atomic<juce::uint64> maximum {0};
+    };
+
+    struct Level
+    {
+        std::vector<Slot> slots;
+        std::atomic<juce::uint64> numPoints {0};
+        Point pending;      // Writer only: the even point waiting for its partner.
+    };
+
+    void write(int level, const Point& point) noexcept;
+    static Point merge(const Point& a, const Point& b) noexcept;
+
+    /** The readings in hundredths of a dB, clamped to 16 bits, one quantity per 16 bits. */
+    static juce::uint64 pack(const std::array<float, numQuantities>& values) noexcept;
+    static std::array<float, numQuantities> unpack(juce::uint64 packed) noexcept;
+
+    std::array<Level, numLevels> levels;
+
+    int samplesPerPoint = 1;
+    int pointPosition = 0;
+    Point current;
+};
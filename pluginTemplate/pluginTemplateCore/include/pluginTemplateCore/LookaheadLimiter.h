@@ -0,0 +1,89 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <vector>
+
+/**
+ * @class LookaheadLimiter
+ * @brief A channel-linked brickwall limiter that delays the signal by its lookahead.
+ *
+ * Per sample, the gain that would bring the loudest channel down to the
+ * ceiling is computed and run through three stages:
+ *  - a sliding minimum over the lookahead window plus one sample, kept with a
+ *    monotonic deque, so each sample costs amortized O(1) however long the
+ *    lookahead is,
+ *  - an envelope with instant attack and an exponential release, and
+ *  - a moving average over the same window, kept as a running sum, which turns
+ *    the attack into a ramp that has fully arrived when the peak leaves the
+ *    delay line.
+ * Because the average only covers values that already include the peak, the
+ * delayed output never exceeds the ceiling (up to rounding).
+ *
+ * The per-sample work is only this gain computation; delaying and multiplying
+ * the channels are vectorized per chunk. The delay line is a ring per channel
+ * that is swapped with the block in contiguous segments, so it costs the same
+ * for any lookahead too. Nothing allocates after prepare().
+ *
+ * SampleType is float or double, both instantiated in LookaheadLimiter.cpp.
+ * The gain path runs in the same precision as the samples.
+ */
+template <typename SampleType>
+class LookaheadLimiter
+{
+public:
+    /** Allocates. The latency, getLatencyInSamples(), is lookaheadMs at the spec's rate. */
+    void prepare(const juce::dsp::ProcessSpec& spec, float lookaheadMs = 5.0f);
+
+    /** Audio thread. Takes effect from the next sample on; the envelopes keep ceiling changes smooth. */
+    void setParameters(float ceilingDb, float releaseMs) noexcept;
+
+    void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    /** Clears the delay line and envelopes, i.e. the next output starts with lookahead samples of silence. */
+    void reset() noexcept;
+
+    [[nodiscard]] int getLatencyInSamples() const noexcept { return lookaheadSamples; }
+
+    /** The smallest gain applied during the last process() call, 1 if it did not limit. */
+    [[nodiscard]] float getLastBlockMinimumGain() const noexcept { return lastBlockMinimumGain; }
+
+private:
+    static constexpr int chunkSize = 256;
+
+    void computeGainCurve(const juce::dsp::AudioBlock<SampleType>& block, size_t offset, int numSamples) noexcept;
+    void delayChannels(const juce::dsp::AudioBlock<SampleType>& block, size_t offset, int numSamples) noexcept;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int lookaheadSamples = 0;   // The delay, D.
+    int windowLength = 1;       // D + 1 samples: the current one and the D ahead of the output.
+
+    SampleType ceilingGain = 1;
+    SampleType releaseCoefficient = 0;
+
+    // Monotonic deque of required gains for the sliding minimum, as a ring of windowLength entries.
+    std::vector<SampleType> dequeGains;
+    std::vector<juce::int64> dequeSampleIndices;
+    int dequeHead = 0;
+    int dequeSize = 0;
+    juce::int64 sampleIndex = 0;
+
+    SampleType envelope = 1;
+
+    // Last windowLength envelope values and their sum, for the moving average.
+    std::vector<SampleType> averageHistory;
+    int averagePosition = 0;
+    double averageSum = 0.0;
+
+    std::vector<SampleType> delayLines;  // numChannels rings of lookaheadSamples samples.
+    int delayPosition = 0;
+
+    std::array<SampleType, chunkSize> peakCurve {};
+    std::array<SampleType, chunkSize> channelMagnitudes {};
+    std::array<SampleType, chunkSize> gainCurve {};
+
+    float lastBlockMinimumGain = 1.0f;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @class LoudnessMeter
+ * @brief Measures loudness according to ITU-R BS.1770-4 and EBU R128 / Tech 3342.
+ *
+ * Each channel runs through the K-weighting pre-filter and RLB high-pass. The
+ * two biquads are evaluated in double precision on SIMD registers whose lanes
+ * hold different channels, so a stereo pair or four channels of a surround
+ * bus cost one filter evaluation per sample. Their squared outputs are summed
+ * per 100 ms sub-block.
+ *
+ * Momentary (400 ms) and short-term (3 s) loudness are running sums over a
+ * ring of sub-block powers, so each sub-block costs the same however long the
+ * windows are. Every sub-block adds one momentary value to the integrated
+ * loudness histogram and one short-term value to the loudness range histogram.
+ * Both are fixed arrays of 0.1 LU bins between the -70 LUFS absolute gate and
+ * +10 LUFS, holding a block count and the summed power per bin. Relative
+ * gating and the LRA percentiles are evaluated on the bins, so memory does not
+ * grow with the session length; integrated loudness and LRA are exact up to
+ * which side of the relative gate the blocks in the gate's bin fall on.
+ *
+ * Float and double input is filtered the same way, in double precision.
+ *
+ * process() runs on the audio thread. The readings are published through
+ * atomics and can be read from any thread.
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr double subBlockSeconds = 0.1;
+    static constexpr int momentarySubBlocks = 4;     // 400 ms
+    static constexpr int shortTermSubBlocks = 30;    // 3 s
+
+    static constexpr float absoluteGateLufs = -70.0f;
+    static constexpr float integratedRelativeGateLu = -10.0f;
+    static constexpr float rangeRelativeGateLu = -20.0f;
+    static constexpr float histogramMaxLufs = 10.0f;
+    static constexpr float histogramBinWidthLu = 0.1f;
+
+    /** Reported for windows that are silent or have not been filled yet. */
+    static constexpr float silenceLufs = -100.0f;
+
+    LoudnessMeter();
+
+    /**
+     * Not real-time safe. The channel set determines the BS.1770 channel
+     * weights: 0 for LFE channels, 1.41 for surround channels and 1 otherwise.
+     * Of an ambisonic set only the omnidirectional W channel is measured.
+     * Resets all readings.
+     */
+    void prepare(const juce::dsp::ProcessSpec& spec, const juce::AudioChannelSet& channelSet = {});
+
+    /** Audio thread. */
+    void process(const juce::AudioBuffer<float>& buffer) noexcept;
+    void process(const juce::AudioBuffer<double>& buffer) noexcept;
+
+    /** The same for a block. Splitting a stream into blocks of any size gives the same readings. */
+    void process(const juce::dsp::AudioBlock<const float>& block) noexcept;
+    void process(const juce::dsp::AudioBlock<const double>& block) noexcept;
+
+    /**
+     * Audio thread. Advances the windows over numSamples samples of digital
+     * silence without filtering them. The filters' state is cleared, i.e. their
+     * tail is taken to have decayed, which it has once the input has been
+     * silent for a few hundred samples. The readings then fall towards
+     * silenceLufs as they would with process().
+     */
+    void processSilence(int numSamples) noexcept;
+
+    /** Clears all readings. Audio thread, or any thread while processing is stopped. */
+    void reset() noexcept;
+
+    /** Any thread. Clears integrated loudness and loudness range at the start of the next process() call. */
+    void requestReset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] float getMomentaryLufs() const noexcept { return momentaryLufs.load(std::memory_order_relaxed); }
+    [[nodiscard]] float getShortTermLufs() const noexcept { return shortTermLufs.load(std::memory_order_relaxed); }
+    [[nodiscard]] float getIntegratedLufs() const noexcept { return integratedLufs.load(std::memory_order_relaxed); }
+    [[nodiscard]] float getLoudnessRangeLu() const noexcept { return loudnessRangeLu.load(std::memory_order_relaxed); }
+
+private:
+    /** Block counts and summed mean-square power of gating blocks, in bins of histogramBinWidthLu. */
+    struct LoudnessHistogram
+    {
+        static constexpr int numBins = (int) ((histogramMaxLufs - absoluteGateLufs) / histogramBinWidthLu + 0.5f);
+
+        /** Adds a block; blocks below the absolute gate are ignored. */
+        void add(double power) noexcept;
+        void clear() noexcept;
+
+        /** Mean power of the blocks in bins from firstBin upwards, 0 if there are none. */
+        [[nodiscard]] double getMeanPower(int firstBin) const noexcept;
+
+        /** The loudness below which the given fraction of the blocks from firstBin upwards lie. */
+        [[nodiscard]] float getPercentileLufs(int firstBin, double fraction) const noexcept;
+
+        [[nodiscard]] static int getBin(float lufs) noexcept;
+        [[nodiscard]] static float getBinCentreLufs(int bin) noexcept;
+
+        std::array<juce::uint32, numBins> counts {};
+        std::array<double, numBins> powers {};
+        juce::uint64 totalCount = 0;
+        double totalPower = 0.0;
+    };
+
+    template <typename SampleType>
+    void processSamples(const juce::dsp::AudioBlock<const SampleType>& block) noexcept;
+
+    template <typename SampleType>
+    void filterAndAccumulate(const juce::dsp::AudioBlock<const SampleType>& block, int startSample, int numSamples) noexcept;
+    void finishSubBlock() noexcept;
+    void publishGatedReadings() noexcept;
+    void clearIntegration() noexcept;
+
+    int numChannels = 0;
+    int numChannelGroups = 0;
+    int subBlockLength = 1;
+    int subBlockPosition = 0;
+
+    // Per-group filter coefficients and state, see LoudnessMeter.cpp.
+    std::vector<double> channelWeights;
+    std::array<double, 10> coefficients {};
+    std::vector<double> filterState;    // 5 vectors per channel group: 4 biquad states and the energy sum.
+
+    std::array<double, shortTermSubBlocks> subBlockPowers {};
+    int subBlockIndex = 0;
+    juce::int64 numSubBlocks = 0;
+    double momentarySum = 0.0;
+    double shortTermSum = 0.0;
+
+    LoudnessHistogram integratedHistogram;
+    LoudnessHistogram rangeHistogram;
+
+    std::atomic<bool> resetRequested {false};
+    std::atomic<float> momentaryLufs {silenceLufs};
+    std::atomic<float> shortTermLufs {silenceLufs};
+    std::atomic<float> integratedLufs {silenceLufs};
+    std::atomic<float> loudnessRangeLu {0.0f};
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pluginTemplateCore/SpscRing.h"
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+/** Output loudness as measured by LoudnessMeter, in LUFS and LU. */
+struct LoudnessReadings
+{
+    float momentaryLufs = -100.0f;
+    float shortTermLufs = -100.0f;
+    float integratedLufs = -100.0f;
+    float loudnessRangeLu = 0.0f;
+};
+
+/**
+ * @struct MeterFrame
+ * @brief The meter readings of one processed block, as handed from the audio thread to the UI.
+ *
+ * Levels are linear peak-meter gains including release, so the largest level
+ * over a batch of frames never misses a transient that happened in between.
+ * Loudness readings are only meaningful as the latest value of a batch.
+ */
+struct MeterFrame
+{
+    static constexpr int maxChannels = 16;
+
+    juce::uint64 sequence = 0;      // Increments by one per pushed frame.
+    juce::int64 samplePosition = 0; // Samples processed since prepareToPlay, at the end of the block.
+    int numChannels = 0;
+    std::array<float, maxChannels> inputLevels {};
+    std::array<float, maxChannels> outputLevels {};
+    float limiterGain = 1.0f;       // Smallest limiter gain in the block, 1 while the limiter is off.
+    LoudnessReadings loudness;
+};
+
+/** About 170 ms of frames at 32-sample blocks and 48 kHz, well above the editor's polling interval. */
+using MeterTelemetryFifo = SpscRing<MeterFrame, 256>;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @class Oversampler
+ * @brief 2x, 4x or 8x oversampling for the nonlinear stages of the processing chain.
+ *
+ * Every factor of two is one half-band stage. Both filter designs exploit
+ * that half the coefficients of a half-band filter are trivial and run as two
+ * polyphase branches at the lower rate, so no work is ever spent on the
+ * zeros stuffed in by upsampling or the samples dropped by downsampling:
+ * - firHalfBand: linear phase Kaiser windowed half-band FIRs, vectorized over
+ *   time with juce::dsp::SIMDRegister.
+ * - iirHalfBandPolyphase: two branches of first order allpass sections at the
+ *   lower rate, with channels and branches packed into SIMD lanes. Much
+ *   shorter latency, but only approximately linear phase in the passband.
+ *
+ * prepare() allocates the stages and buffers for the highest factor, so the
+ * factor can be switched on the audio thread without allocating.
+ * This implementation is real-time safe.
+ */
+class Oversampler
+{
+public:
+    enum class FilterType
+    {
+        firHalfBand,
+        iirHalfBandPolyphase
+    };
+
+    static constexpr int maxFactorLog2 = 3;
+
+    Oversampler();
+    ~Oversampler();
+
+    /** The spec is at the host rate; maximumBlockSize bounds the blocks passed to processSamplesUp(). */
+    void prepare(const juce::dsp::ProcessSpec& spec, FilterType type = FilterType::firHalfBand);
+
+    /** Clears the filter states of all stages. */
+    void reset() noexcept;
+
+    /** Sets the factor to 2^factorLog2, from 0 (off) up to maxFactorLog2. Newly enabled stages start from silence. */
+    void setFactorLog2(int newFactorLog2) noexcept;
+
+    [[nodiscard]] int getFactorLog2() const noexcept { return factorLog2; }
+    [[nodiscard]] int getFactor() const noexcept { return 1 << factorLog2; }
+    [[nodiscard]] FilterType getFilterType() const noexcept { return filterType; }
+
+    /**
+     * The round trip delay of processSamplesUp() followed by processSamplesDown()
+     * in samples at the host rate, measured at low frequencies. Only the
+     * first stage contributes whole samples, so this is usually fractional.
+     */
+    [[nodiscard]] float getLatencyInSamples() const noexcept { return getLatencyInSamples(factorLog2); }
+
+    /** The latency getLatencyInSamples() will report once the factor is 2^factorLog2. */
+    [[nodiscard]] float getLatencyInSamples(int forFactorLog2) const noexcept;
+
+    /**
+     * Upsamples the input into an internal buffer and returns it. The returned
+     * block has getFactor() times as many samples and stays valid until the
+     * matching processSamplesDown(). Requires a factor of at least 2.
+     *
+     * Input longer than the prepared maximumBlockSize, or with a different
+     * channel count, would overrun the stage buffers. It is refused: nothing
+     * is filtered, an empty block is returned and the matching
+     * processSamplesDown() leaves its output untouched.
+     */
+    juce::dsp::AudioBlock<float> processSamplesUp(const juce::dsp::AudioBlock<const float>& input) noexcept;
+
+    /** Downsamples the block returned by the last processSamplesUp() into output. */
+    void processSamplesDown(juce::dsp::AudioBlock<float>& output) noexcept;
+
+    /**
+     * Runs oversampledProcess on the oversampled version of the block and
+     * writes the result back in place. With oversampling off the block is
+     * passed through directly. A block longer than the prepared
+     * maximumBlockSize, from a host that sends more than it announced, is
+     * processed in pieces of at most that size.
+     */
+    template <typename Function>
+    void process(juce::dsp::AudioBlock<float>& block, Function&& oversampledProcess)
+    {
+        if (factorLog2 == 0)
+        {
+            oversampledProcess(block);
+            return;
+        }
+
+        const auto numSamples = block.getNumSamples();
+
+        for (size_t start = 0; start < numSamples && maxBlockSize > 0; start += (size_t) maxBlockSize)
+        {
+            auto piece = block.getSubBlock(start, juce::jmin((size_t) maxBlockSize, numSamples - start));
+            auto oversampledBlock = processSamplesUp(piece);
+            oversampledProcess(oversampledBlock);
+            processSamplesDown(piece);
+        }
+    }
+
+private:
+    class Stage;
+    class FirStage;
+    class IirStage;
+
+    std::vector<std::unique_ptr<Stage>> stages;
+    FilterType filterType = FilterType::firHalfBand;
+    int factorLog2 = 0;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    int numUpsampledSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(Oversampler)
+};
@@ -3,15 +3,26 @@
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "pluginTemplateCore/SpscRing.h"
 #include <vector>
 
 /**
- * @class LevelMeter
+ * @class PeakLevelMeter
  * @brief Calculates and holds the peak level from an audio stream for UI display.
  *
- * This class finds the true peak value within each processed block and applies
- * a hold-and-release characteristic, making it suitable for a visual meter.
- * This implementation is real-time safe.
+ * This class finds the true peak value within each processed block with an
+ * abs-max reduction over sub-blocks of a fixed length, using the unrolled
+ * FixedSizeKernels, plus a scalar tail, and applies a hold-and-release characteristic,
+ * making it suitable for a visual meter. The release is never iterated per
+ * sample: each channel stores its last peak together with the sample time it
+ * was reached, and the exponential release is evaluated in closed form only
+ * when a new block is compared against it or when the UI reads the level.
+ *
+ * Ballistics: a block's peak is timestamped at the end of its block, so
+ * compared to per-sample release the reading is never lower and at most one
+ * block's worth of release higher, i.e. 20 dB * blockSize / releaseSamples
+ * (0.13 dB for 512 samples at 48 kHz with the default 1.7 s release).
+ * This implementation is real-time safe and lock-free.
  */
 class PeakLevelMeter
 {
@@ -21,16 +32,64 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec, float releaseTimeMs = 1700.0f); // Type I PPM release time: 20dB fall in 1.7s
 
     void process(const juce::AudioBuffer<float>& buffer);
+    void process(const juce::AudioBuffer<double>& buffer);
+
+    /** The same for a block, e.g. one tile of a ProcessingChain. */
+    void process(const juce::dsp::AudioBlock<const float>& block);
+    void process(const juce::dsp::AudioBlock<const double>& block);
+
+    /**
+     * Advances the meter over numSamples samples of silence without reading
+     * them: the held peaks keep releasing exactly as if process() had seen the
+     * silence, down to the floor where they are dropped.
+     */
+    void processSilence(int numSamples) noexcept;
 
     float getLevelDb(int channel) const;
 
     float getMonoPeakDb() const;
 
+    /**
+     * Writes the current linear level of each channel (including release) to
+     * destination, up to maxChannels. Meant to be called by the audio thread
+     * right after process() to fill a MeterFrame.
+     */
+    void copyLevels(float* destination, int maxChannels) const noexcept;
+
     void reset();
 
 private:
-    std::vector<juce::Atomic<float>> peakGains;
+    /** A channel's held peak and the sample clock value it was reached at, packed for atomic access. */
+    struct HeldPeak
+    {
+        float gain = 0.0f;
+        juce::uint32 timestamp = 0;
+
+        static juce::uint64 pack(HeldPeak) noexcept;
+        static HeldPeak unpack(juce::uint64) noexcept;
+    };
+
+    /** The levels are kept in float for either sample type. */
+    template <typename SampleType>
+    void processSamples(const juce::dsp::AudioBlock<const SampleType>& block);
+
+    static constexpr int magnitudeSubBlockSize = 64;
+
+    /** Attack and floor handling for a channel whose block ending at blockEnd peaked at blockPeak. */
+    void holdPeak(int channel, float blockPeak, juce::uint32 blockEnd) noexcept;
+
+    float getReleasedGain(HeldPeak peak, juce::uint32 now) const noexcept;
+    float getCurrentGain(int channel) const noexcept;
+
+    /** Each channel's state gets its own cache line, so channels never share one with each other. */
+    struct alignas(cacheLineSize) PaddedHeldPeak
+    {
+        juce::Atomic<juce::uint64> packed;
+    };
+
+    std::vector<PaddedHeldPeak> heldPeaks;
+    alignas(cacheLineSize) juce::Atomic<juce::uint32> sampleClock { 0 };
 
-    float releaseCoeff = 1.0f;
+    float releaseLogCoeff = 0.0f; // natural log of the per-sample release factor
     int numChannels = 0;
 };
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "pluginTemplateCore/SpscRing.h"
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @class ProcessProfiler
+ * @brief Per-stage timing and CPU load of the audio callback, readable from any thread.
+ *
+ * The audio thread is the only writer. It times each stage of a block, or of
+ * each tile when the stages run in a ProcessingChain, with
+ * std::chrono::steady_clock and counts the duration into a histogram of
+ * power-of-two nanosecond buckets. Every block's total time is also divided
+ * by its deadline, numSamples / sampleRate, and counted into a load
+ * histogram of 5 % buckets; the slowest block so far is kept separately.
+ *
+ * All counters are relaxed atomics written with plain load/store pairs, so
+ * recording costs two clock reads and a handful of uncontended stores per
+ * stage. Readers take a Snapshot, which may mix counts from adjacent blocks
+ * but never blocks the audio thread. Resets are requested by readers and
+ * carried out by the audio thread at the start of its next block.
+ *
+ * The instrumentation in the processor is only compiled when PROCESS_PROFILING
+ * is non-zero, see PROCESS_PROFILER_SCOPE.
+ */
+class ProcessProfiler
+{
+public:
+    enum class Stage
+    {
+        inputMeter,
+        dsp,
+        limiter,
+        outputMeter,
+        loudness,
+        block, // The whole processBlock call.
+        numStages
+    };
+
+    static constexpr int numStages = (int) Stage::numStages;
+    static constexpr int numTimeBuckets = 32;   // Bucket i counts durations in [2^i, 2^(i+1)) ns.
+    static constexpr int numLoadBuckets = 41;   // Bucket i counts loads in [5i %, 5(i+1) %); the last one everything above 200 %.
+    static constexpr float loadBucketWidth = 0.05f;
+
+    static const char* getStageName(Stage stage) noexcept;
+
+    /** Sets the rate that block deadlines are computed from. Not real-time safe with concurrent recording. */
+    void prepare(double sampleRate) noexcept;
+
+    /** Asks the audio thread to clear all statistics before its next block. Callable from any thread. */
+    void requestReset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    using Clock = std::chrono::steady_clock;
+
+    /** Times a stage for as long as it exists. */
+    class ScopedStage
+    {
+    public:
+        ScopedStage(ProcessProfiler& profilerToUse, Stage stageToTime) noexcept
+            : profiler(profilerToUse), stage(stageToTime), start(Clock::now()) {}
+
+        ~ScopedStage() { profiler.recordStage(stage, Clock::now() - start); }
+
+    private:
+        ProcessProfiler& profiler;
+        Stage stage;
+        Clock::time_point start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    /** Times a whole block and records its load; also carries out pending resets. */
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(ProcessProfiler& profilerToUse, int numSamplesInBlock) noexcept
+            : profiler(profilerToUse), numSamples(numSamplesInBlock)
+        {
+            profiler.beginBlock();
+            start = Clock::now();
+        }
+
+        ~ScopedBlock() { profiler.recordBlock(numSamples, Clock::now() - start); }
+
+    private:
+        ProcessProfiler& profiler;
+        int numSamples;
+        Clock::time_point start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    struct StageSnapshot
+    {
+        juce::uint64 count = 0;
+        juce::uint64 totalNs = 0;
+        juce::uint64 maxNs = 0;
+        std::array<juce::uint64, numTimeBuckets> histogram {};
+
+        [[nodiscard]] double getMeanNs() const noexcept { return count > 0 ? (double) totalNs / (double) count : 0.0; }
+
+        /** The upper edge of the bucket holding the given fraction of all counts, in ns. */
+        [[nodiscard]] double getPercentileNs(double fraction) const noexcept;
+    };
+
+    struct Snapshot
+    {
+        double sampleRate = 0.0;
+        std::array<StageSnapshot, numStages> stages {};
+
+        std::array<juce::uint64, numLoadBuckets> loadHistogram {};
+        double totalLoad = 0.0;          // Sum of all block loads, for the mean.
+        juce::uint64 numOverruns = 0;    // Blocks that took longer than their deadline.
+
+        juce::uint64 worstBlockNs = 0;
+        int worstBlockNumSamples = 0;
+        float worstBlockLoad = 0.0f;
+
+        [[nodiscard]] const StageSnapshot& getStage(Stage stage) const noexcept { return stages[(size_t) stage]; }
+        [[nodiscard]] double getMeanLoad() const noexcept;
+
+        /** The upper edge of the load bucket holding the given fraction of all blocks, as a ratio of the deadline. */
+        [[nodiscard]] double getLoadPercentile(double fraction) const noexcept;
+    };
+
+    [[nodiscard]] Snapshot getSnapshot() const noexcept;
+
+private:
+    using Counter = std::atomic<juce::uint64>;
+
+    /** Single-writer increment without a locked read-modify-write. */
+    static void add(Counter& counter, juce::uint64 amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    struct alignas(cacheLineSize) StageCounters
+    {
+        Counter count {0};
+        Counter totalNs {0};
+        Counter maxNs {0};
+        std::array<Counter, numTimeBuckets> histogram {};
+    };
+
+    /** Counts the duration into the stage's statistics and returns it in ns. */
+    juce::uint64 recordStage(Stage stage, Clock::duration duration) noexcept;
+    void beginBlock() noexcept;
+    void recordBlock(int numSamples, Clock::duration duration) noexcept;
+    void clear() noexcept;
+
+    std::array<StageCounters, numStages> stageCounters;
+
+    alignas(cacheLineSize) std::array<Counter, numLoadBuckets> loadHistogram {};
+    std::atomic<double> totalLoad {0.0};
+    Counter numOverruns {0};
+    std::atomic<double> nsPerSample {0.0};
+
+    // The worst block is published as one packed word, so readers never see half of an update.
+    Counter worstBlock {0}; // Upper 40 bits ns, lower 24 bits numSamples.
+
+    alignas(cacheLineSize) std::atomic<bool> resetRequested {false};
+};
+
+#if PROCESS_PROFILING
+ /** Times the rest of the enclosing scope as the given ProcessProfiler::Stage. */
+ #define PROCESS_PROFILER_SCOPE(profiler, stage) \
+    const ProcessProfiler::ScopedStage JUCE_JOIN_MACRO(processProfilerScope_, __LINE__) {profiler, stage}
+ /** Times the rest of the enclosing scope as a whole block of numSamples. */
+ #define PROCESS_PROFILER_BLOCK(profiler, numSamples) \
+    const ProcessProfiler::ScopedBlock JUCE_JOIN_MACRO(processProfilerBlock_, __LINE__) {profiler, numSamples}
+#else
+ #define PROCESS_PROFILER_SCOPE(profiler, stage)
+ #define PROCESS_PROFILER_BLOCK(profiler, numSamples)
+#endif
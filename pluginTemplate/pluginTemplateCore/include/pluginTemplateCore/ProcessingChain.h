@@ -0,0 +1,136 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/** Marks a stage of a ProcessingChain that has to see the whole block at once, see wholeBlock(). */
+template <typename Function>
+struct WholeBlockStage
+{
+    Function function;
+};
+
+/** Wraps a stage so that a ProcessingChain calls it once with the whole block instead of per tile. */
+template <typename Function>
+WholeBlockStage<std::decay_t<Function>> wholeBlock(Function&& function)
+{
+    return {std::forward<Function>(function)};
+}
+
+/** The tile size the stages are tuned for: the internal chunk length of the limiter, gain ramps and spectrum capture. */
+constexpr size_t processingTileGranularity = 256;
+
+/**
+ * The tile length for numChannels channels of SampleType: a multiple of
+ * processingTileGranularity, and at least that, whose tiles fit into tileBytes.
+ * The default is about half of a typical L1 data cache. Pass the channel count
+ * of the widest block a stage touches per tile sample, e.g. channels times
+ * the oversampling factor.
+ */
+template <typename SampleType = float>
+size_t getProcessingTileLength(size_t numChannels, size_t tileBytes = 16384) noexcept
+{
+    const auto numSamples = tileBytes / (sizeof(SampleType) * juce::jmax((size_t) 1, numChannels));
+    return juce::jmax(processingTileGranularity, numSamples / processingTileGranularity * processingTileGranularity);
+}
+
+/**
+ * @class ProcessingChain
+ * @brief Runs a fixed sequence of stages over a block in one sweep of cache-sized tiles.
+ *
+ * Running each stage over the whole block reloads every sample from memory
+ * once per stage, and with the large blocks of an offline bounce the buffer no
+ * longer fits in L1 or L2. The chain instead cuts the block into tiles of
+ * tileLength samples and runs all stages on one tile before moving on to the
+ * next, so the tile stays in cache between stages.
+ *
+ * Stages are callables taking a const juce::dsp::AudioBlock<SampleType>&,
+ * with the sample type of the processed block, float or double. They are
+ * stored by value in a tuple and called through a fold expression, so the
+ * compiler sees the whole chain and nothing is dispatched at run time. Stages
+ * must carry their state across calls, which all streaming processors in this
+ * library do. A stage that needs the whole block at once is wrapped with
+ * wholeBlock(): the tiled stages before it finish the entire block first, it
+ * runs once, and tiling resumes after it. Where those boundaries fall is
+ * worked out at compile time.
+ *
+ * The chain is cheap to build, so processBlock can assemble one per block
+ * from lambdas with makeProcessingChain(). It never allocates.
+ */
+template <typename... Stages>
+class ProcessingChain
+{
+public:
+    ProcessingChain(size_t tileLengthToUse, Stages... stagesToUse)
+        : tileLength(juce::jmax((size_t) 1, tileLengthToUse)), stages(std::move(stagesToUse)...) {}
+
+    template <typename SampleType>
+    void process(const juce::dsp::AudioBlock<SampleType>& block)
+    {
+        processFrom<0>(block);
+    }
+
+private:
+    template <typename Stage>
+    struct IsWholeBlock : std::false_type {};
+
+    template <typename Function>
+    struct IsWholeBlock<WholeBlockStage<Function>> : std::true_type {};
+
+    static constexpr size_t numStages = sizeof...(Stages);
+
+    /** The index of the first whole-block stage at or after first, numStages if there is none. */
+    static constexpr size_t findSegmentEnd(size_t first) noexcept
+    {
+        constexpr bool wholeBlockFlags[] {IsWholeBlock<Stages>::value..., true};
+
+        while (first < numStages && ! wholeBlockFlags[first])
+            ++first;
+
+        return first;
+    }
+
+    template <size_t first, typename SampleType>
+    void processFrom(const juce::dsp::AudioBlock<SampleType>& block)
+    {
+        if constexpr (first < numStages)
+        {
+            constexpr auto segmentEnd = findSegmentEnd(first);
+
+            if constexpr (segmentEnd > first)
+                processTiled<first>(block, std::make_index_sequence<segmentEnd - first>());
+
+            if constexpr (segmentEnd < numStages)
+            {
+                std::get<segmentEnd>(stages).function(block);
+                processFrom<segmentEnd + 1>(block);
+            }
+        }
+    }
+
+    template <size_t first, typename SampleType, size_t... offsets>
+    void processTiled(const juce::dsp::AudioBlock<SampleType>& block, std::index_sequence<offsets...>)
+    {
+        const auto numSamples = block.getNumSamples();
+
+        for (size_t start = 0; start < numSamples; start += tileLength)
+        {
+            const auto tile = block.getSubBlock(start, juce::jmin(tileLength, numSamples - start));
+            (std::get<first + offsets>(stages)(tile), ...);
+        }
+    }
+
+    size_t tileLength;
+    std::tuple<Stages...> stages;
+};
+
+/** Builds a chain with the stage types deduced, e.g. from lambdas. */
+template <typename... Stages>
+ProcessingChain<std::decay_t<Stages>...> makeProcessingChain(size_t tileLength, Stages&&... stages)
+{
+    return {tileLength, std::forward<Stages>(stages)...};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * @namespace SilenceDetection
+ * @brief Tells digital silence from signal, for skipping work on idle tracks.
+ *
+ * isSilent() scans each channel in 64 sample sub-blocks with the unrolled
+ * FixedSizeKernels and returns as soon as one of them exceeds the threshold,
+ * so a block with signal costs a few dozen samples of scanning and only a
+ * silent one is read in full.
+ */
+namespace SilenceDetection
+{
+    /** -150 dB, below the least significant bit of 24-bit audio. */
+    constexpr float threshold = 3.0e-8f;
+
+    /** Whether no sample of the block exceeds threshold in magnitude. */
+    [[nodiscard]] bool isSilent(const juce::dsp::AudioBlock<const float>& block) noexcept;
+    [[nodiscard]] bool isSilent(const juce::dsp::AudioBlock<const double>& block) noexcept;
+}
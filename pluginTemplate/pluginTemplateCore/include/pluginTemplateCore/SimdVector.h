@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <cmath>
+#include <cstring>
+
+/**
+ * @namespace SimdVector
+ * @brief The SIMD register type and unaligned loads and stores shared by the vectorized kernels.
+ *
+ * Vector is juce::dsp::SIMDRegister where JUCE provides SIMD. Otherwise it is
+ * a two-lane stand-in with the few operations the kernels use, so they still
+ * compile and run without SIMD.
+ *
+ * SIMDRegister::fromRawArray() requires aligned data. Host buffers, sub-blocks
+ * and FIR taps start at any sample offset, so the kernels load and store with
+ * memcpy instead, which compiles to a single unaligned load or store.
+ */
+namespace SimdVector
+{
+   #if JUCE_USE_SIMD
+    template <typename SampleType>
+    using Vector = juce::dsp::SIMDRegister<SampleType>;
+   #else
+    template <typename SampleType>
+    struct Vector
+    {
+        static constexpr size_t SIMDNumElements = 2;
+        SampleType lanes[SIMDNumElements];
+
+        static Vector expand(SampleType value) noexcept { return {{value, value}}; }
+        static Vector abs(Vector v) noexcept { return {{std::abs(v.lanes[0]), std::abs(v.lanes[1])}}; }
+        static Vector max(Vector a, Vector b) noexcept { return {{juce::jmax(a.lanes[0], b.lanes[0]), juce::jmax(a.lanes[1], b.lanes[1])}}; }
+        Vector operator+(Vector other) const noexcept { return {{lanes[0] + other.lanes[0], lanes[1] + other.lanes[1]}}; }
+        Vector operator-(Vector other) const noexcept { return {{lanes[0] - other.lanes[0], lanes[1] - other.lanes[1]}}; }
+        Vector operator*(Vector other) const noexcept { return {{lanes[0] * other.lanes[0], lanes[1] * other.lanes[1]}}; }
+        Vector& operator+=(Vector other) noexcept { return *this = *this + other; }
+    };
+   #endif
+
+    template <typename SampleType>
+    inline Vector<SampleType> loadUnaligned(const SampleType* source) noexcept
+    {
+        Vector<SampleType> vector;
+        std::memcpy(&vector, source, sizeof(vector));
+        return vector;
+    }
+
+    template <typename SampleType>
+    inline void storeUnaligned(Vector<SampleType> vector, SampleType* destination) noexcept
+    {
+        std::memcpy(destination, &vector, sizeof(vector));
+    }
+}
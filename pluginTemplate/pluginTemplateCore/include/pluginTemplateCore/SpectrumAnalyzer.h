@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pluginTemplateCore/SpscRing.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @class SpectrumAnalyzer
+ * @brief A log-frequency spectrum of the processed signal, computed off the audio thread.
+ *
+ * The audio thread only calls pushSamples(), which mixes the block down to
+ * mono into fixed-size chunks of a wait-free SpscRing and returns. Nothing
+ * is captured while the analyzer is inactive, i.e. while no editor shows it.
+ *
+ * The analysis runs in useTimeSlice() on a juce::TimeSliceThread shared by
+ * all plugin instances. It decimates the capture to at most 48 kHz by
+ * averaging, applies a Hann window with vectorized operations, runs a
+ * juce::dsp::FFT, aggregates the bins into numBands logarithmically spaced
+ * bands between minFrequency and maxFrequency and smooths each band with an
+ * instant attack and an exponential release. The result is published as a
+ * fixed-size binary frame:
+ *
+ *   offset  size  field
+ *        0     4  magic "PTSP"
+ *        4     2  version (1)
+ *        6     2  numBands (B)
+ *        8     4  generation, incremented per published frame
+ *       12     4  float32 frame interval in ms, i.e. how often a new frame can be expected
+ *       16     4  float32 lowest band edge in Hz
+ *       20     4  float32 highest band edge in Hz
+ *       24   4*B  float32 band level in dB, lowest band first
+ *
+ * Frame intervals grow with the number of active analyzers in the process,
+ * so the total analysis rate, and the rate at which the Web UIs fetch
+ * frames, stays bounded however many instances have their editor open.
+ */
+class SpectrumAnalyzer : public juce::TimeSliceClient
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBands = 96;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr double maxAnalysisRate = 48000.0;
+
+    static constexpr juce::uint32 magic = 0x50535450; // "PTSP" read as a little-endian uint32
+    static constexpr juce::uint16 version = 1;
+    static constexpr size_t headerSize = 24;
+    static constexpr size_t frameSize = headerSize + sizeof(float) * numBands;
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    /** Not real-time safe. Safe to call while the analyzer is registered with a running thread. */
+    void prepare(double sampleRate, float releaseTimeMs = 300.0f);
+
+    /** Audio thread. Captures the block's mono downmix if the analyzer is active. */
+    void pushSamples(const juce::AudioBuffer<float>& buffer) noexcept;
+    void pushSamples(const juce::AudioBuffer<double>& buffer) noexcept;
+
+    /** The same for a block. Blocks shorter than captureChunkSize are sent as partly filled chunks. */
+    void pushSamples(const juce::dsp::AudioBlock<const float>& block) noexcept;
+    void pushSamples(const juce::dsp::AudioBlock<const double>& block) noexcept;
+
+    /**
+     * Starts or stops capturing and analysing. Inactive analyzers cost one
+     * atomic load per block on the audio thread and nothing on the worker.
+     */
+    void setActive(bool shouldBeActive) noexcept;
+    [[nodiscard]] bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    /** Changes whenever a new frame was published; use it to skip unchanged reads. */
+    [[nodiscard]] juce::uint64 getGeneration() const noexcept { return generation.load(std::memory_order_acquire); }
+
+    /** Copies the latest frame into destination, which must hold frameSize bytes. Any thread. */
+    void copyFrame(std::byte* destination) const noexcept;
+
+    int useTimeSlice() override;
+
+private:
+    static constexpr int captureChunkSize = 256;
+
+    struct CaptureChunk
+    {
+        std::array<float, captureChunkSize> samples;
+        int numSamples;
+    };
+
+    /** About 340 ms at 48 kHz, several times the longest frame interval. */
+    using CaptureFifo = SpscRing<CaptureChunk, 64>;
+
+    /** Downmixes into float chunks, which is all the display needs for either sample type. */
+    template <typename SampleType>
+    void captureSamples(const juce::dsp::AudioBlock<const SampleType>& block) noexcept;
+
+    void consumeChunk(const CaptureChunk& chunk) noexcept;
+    void analyse(double elapsedMs) noexcept;
+    void publish() noexcept;
+    [[nodiscard]] double getFrameIntervalMs() const noexcept;
+
+    std::atomic<bool> active {false};
+    CaptureFifo captureFifo;
+
+    // Worker state, guarded by workerLock against prepare().
+    juce::CriticalSection workerLock;
+    juce::dsp::FFT fft {fftOrder};
+    std::vector<float> window;
+    std::vector<float> fftData;
+    std::vector<float> history;         // Circular, the last fftSize decimated samples.
+    int historyWritePosition = 0;
+    int numNewSamples = 0;
+    int decimationFactor = 1;
+    int decimationCount = 0;
+    float decimationSum = 0.0f;
+    double analysisRate = 0.0;
+    float windowGain = 1.0f;            // Scales magnitudes so a full-scale sine reads 0 dB.
+    float releaseTimeMs = 300.0f;
+    double lastAnalysisMs = 0.0;
+
+    struct BandBins
+    {
+        int firstBin = 0;
+        int lastBin = 0;                // Inclusive; equal to firstBin for bands narrower than a bin.
+        float interpolation = -1.0f;    // >= 0: read between firstBin and firstBin + 1 instead.
+    };
+
+    std::array<BandBins, numBands> bandBins {};
+    std::array<float, numBands> smoothedLevels {};
+
+    // The published frame, guarded by frameLock against readers.
+    mutable juce::SpinLock frameLock;
+    std::array<std::byte, frameSize> frame {};
+    std::atomic<juce::uint64> generation {0};
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumAnalyzer)
+};
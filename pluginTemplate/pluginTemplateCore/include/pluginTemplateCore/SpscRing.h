@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/** The size cache-line padding is based on; Apple Silicon uses 128 byte lines. */
+#if defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t cacheLineSize = 128;
+#else
+inline constexpr std::size_t cacheLineSize = 64;
+#endif
+
+/**
+ * @class SpscRing
+ * @brief A wait-free single-producer/single-consumer ring buffer of fixed capacity.
+ *
+ * Intended for handing data from the audio thread to a reader thread: push()
+ * never blocks or allocates and simply drops the item (counting it) when the
+ * reader has fallen behind. The producer's and the consumer's indices live on
+ * separate cache lines, and each side keeps a private copy of the other
+ * side's index so the shared lines are only touched when the cached view
+ * runs out.
+ *
+ * @tparam T        A trivially copyable item type.
+ * @tparam capacity The number of slots; must be a power of two.
+ */
+template <typename T, std::size_t capacity>
+class SpscRing
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing items are copied with plain assignment");
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    /** Producer only. Returns false, and drops the item, if the ring is full. */
+    bool push(const T& item) noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+
+        if (write - cachedReadIndex == capacity)
+        {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+
+            if (write - cachedReadIndex == capacity)
+            {
+                numDropped.store(numDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        slots[write & (capacity - 1)] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer only. Hands every item that is ready, oldest first, to
+     * consumer(const T&) and returns how many there were, at most maxItems.
+     */
+    template <typename Consumer>
+    std::size_t popAll(Consumer&& consumer, std::size_t maxItems = capacity) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+
+        if (cachedWriteIndex == read)
+            cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+
+        const auto numItems = juce::jmin(cachedWriteIndex - read, maxItems);
+
+        for (std::size_t i = 0; i < numItems; ++i)
+            consumer(static_cast<const T&>(slots[(read + i) & (capacity - 1)]));
+
+        readIndex.store(read + numItems, std::memory_order_release);
+        return numItems;
+    }
+
+    /** Consumer only. Discards everything that is currently queued. */
+    void clear() noexcept
+    {
+        readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /** The number of items push() had to drop because the ring was full. */
+    [[nodiscard]] juce::uint64 getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t getCapacity() noexcept { return capacity; }
+
+private:
+    // Producer side: written by push(), read by the consumer.
+    alignas(cacheLineSize) std::atomic<std::size_t> writeIndex { 0 };
+    std::size_t cachedReadIndex = 0;
+    std::atomic<juce::uint64> numDropped { 0 };
+
+    // Consumer side: written by popAll(), read by the producer.
+    alignas(cacheLineSize) std::atomic<std::size_t> readIndex { 0 };
+    std::size_t cachedWriteIndex = 0;
+
+    alignas(cacheLineSize) std::array<T, capacity> slots {};
+};
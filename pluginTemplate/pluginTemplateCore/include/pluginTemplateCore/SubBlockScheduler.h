@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Splits a block of any length into sub-blocks of exactly subBlockSize
+ * samples, handed to processSubBlock, and the shorter rest, if any, handed to
+ * processTail.
+ *
+ * Hosts call processBlock with anything from 1 to 8192 samples, and the length
+ * may change from call to call. Behind this split the bulk of the work runs on
+ * one length known at compile time, so processSubBlock can use kernels
+ * instantiated for it (see FixedSizeKernels and DspProcessor::processFixed()),
+ * and whatever it does once per call, such as reading parameters, happens at a
+ * steady rate whatever the host's block size. Only the tail uses runtime
+ * length kernels. It is not carried over into the next block, as that would
+ * cost a sub-block of latency.
+ *
+ * Both callables take a const juce::dsp::AudioBlock<SampleType>&. Header-only
+ * and inlined, so the split costs a loop and nothing else.
+ */
+template <int subBlockSize, typename SampleType, typename SubBlockFunction, typename TailFunction>
+void forEachSubBlock(const juce::dsp::AudioBlock<SampleType>& block,
+                     SubBlockFunction&& processSubBlock,
+                     TailFunction&& processTail)
+{
+    static_assert(subBlockSize > 0, "Sub-blocks need at least one sample");
+
+    const auto numSamples = block.getNumSamples();
+    const auto numFullSamples = numSamples - numSamples % (size_t) subBlockSize;
+
+    for (size_t start = 0; start < numFullSamples; start += (size_t) subBlockSize)
+        processSubBlock(block.getSubBlock(start, (size_t) subBlockSize));
+
+    if (numFullSamples < numSamples)
+        processTail(block.getSubBlock(numFullSamples, numSamples - numFullSamples));
+}
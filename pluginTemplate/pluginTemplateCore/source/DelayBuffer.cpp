@@ -0,0 +1,100 @@
+#include "pluginTemplateCore/DelayBuffer.h"
+
+#include <algorithm>
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, int maxDelaySamples)
+{
+    numChannels = (int) spec.numChannels;
+    maxDelay = juce::jmax(0, maxDelaySamples);
+    capacity = maxDelay + juce::jmax(1, (int) spec.maximumBlockSize);
+    rings.assign((size_t) (numChannels * capacity), SampleType(0));
+
+    reset();
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::reset() noexcept
+{
+    std::fill(rings.begin(), rings.end(), SampleType(0));
+    writePosition = 0;
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::push(const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+{
+    jassert((int) block.getNumChannels() <= numChannels);
+
+    // Anything older than the last capacity samples would be overwritten within this call anyway.
+    const auto numSamples = (int) juce::jmin(block.getNumSamples(), (size_t) capacity);
+    const auto offset = block.getNumSamples() - (size_t) numSamples;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto numSegmentSamples = juce::jmin(numSamples - done, capacity - writePosition);
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            const auto* samples = block.getChannelPointer(channel) + offset + (size_t) done;
+            std::copy(samples, samples + numSegmentSamples, rings.data() + channel * (size_t) capacity + (size_t) writePosition);
+        }
+
+        done += numSegmentSamples;
+        writePosition = (writePosition + numSegmentSamples) % capacity;
+    }
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block, int delaySamples) noexcept
+{
+    jassert(delaySamples >= 0 && delaySamples <= maxDelay);
+    const auto delay = juce::jlimit(0, maxDelay, delaySamples);
+
+    // In pieces of at most the prepared block size, so the samples to read have
+    // not been overwritten yet by the ones just pushed.
+    const auto maxPieceLength = (size_t) (capacity - maxDelay);
+
+    for (size_t start = 0; start < block.getNumSamples(); start += maxPieceLength)
+    {
+        const auto piece = block.getSubBlock(start, juce::jmin(maxPieceLength, block.getNumSamples() - start));
+        const auto numPieceSamples = (int) piece.getNumSamples();
+
+        push(piece);
+        copyFromRing(piece, (writePosition + 2 * capacity - numPieceSamples - delay) % capacity);
+    }
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::copyLatest(const juce::dsp::AudioBlock<SampleType>& destination) const noexcept
+{
+    jassert((int) destination.getNumSamples() <= maxDelay);
+    const auto numSamples = juce::jmin((int) destination.getNumSamples(), maxDelay);
+
+    copyFromRing(destination.getSubBlock(0, (size_t) numSamples), (writePosition + capacity - numSamples) % capacity);
+}
+
+template <typename SampleType>
+void DelayBuffer<SampleType>::copyFromRing(const juce::dsp::AudioBlock<SampleType>& destination, int startPosition) const noexcept
+{
+    jassert((int) destination.getNumChannels() <= numChannels);
+
+    const auto numSamples = (int) destination.getNumSamples();
+    int position = startPosition;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto numSegmentSamples = juce::jmin(numSamples - done, capacity - position);
+
+        for (size_t channel = 0; channel < destination.getNumChannels(); ++channel)
+        {
+            const auto* ring = rings.data() + channel * (size_t) capacity + (size_t) position;
+            std::copy(ring, ring + numSegmentSamples, destination.getChannelPointer(channel) + (size_t) done);
+        }
+
+        done += numSegmentSamples;
+        position = (position + numSegmentSamples) % capacity;
+    }
+}
+
+template class DelayBuffer<float>;
+template class DelayBuffer<double>;
@@ -1,15 +1,175 @@
 #include "pluginTemplateCore/DspProcessor.h"
+#include "pluginTemplateCore/FixedSizeKernels.h"
+#include "pluginTemplateCore/GainKernels.h"
 
+#include <cmath>
 
-void DspProcessor::process(juce::AudioBuffer<float>& buffer, float gainToApply)
+namespace
 {
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    // Multiplicative ramps cannot start or end at silence, so ramps touching
+    // gains below this (-100 dB) fall back to a linear shape.
+    constexpr double minimumMultiplicativeGain = 1.0e-5;
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, float rampTimeMs, RampShape shape)
+{
+    rampShape = shape;
+    rampLengthSamples = juce::jmax(1, juce::roundToInt(spec.sampleRate * (rampTimeMs / 1000.0f)));
+    reset();
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::reset()
+{
+    samplesUntilTarget = 0;
+    rampStep = 0;
+    snapToNextGain = true;
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::startRamp(SampleType newTargetGain)
+{
+    targetGain = newTargetGain;
+    samplesUntilTarget = rampLengthSamples;
+
+    rampIsMultiplicative = rampShape == RampShape::multiplicative
+                        && currentGain > minimumMultiplicativeGain
+                        && targetGain > minimumMultiplicativeGain;
+
+    if (rampIsMultiplicative)
+        rampStep = std::pow(targetGain / currentGain, SampleType(1) / (SampleType) rampLengthSamples);
+    else
+        rampStep = (targetGain - currentGain) / (SampleType) rampLengthSamples;
+}
+
+template <typename SampleType>
+SampleType DspProcessor<SampleType>::applyRamp(const juce::dsp::AudioBlock<SampleType>& block, int numRampSamples)
+{
+    const auto numChannels = block.getNumChannels();
+
+    // A single channel is cheapest with the in-place ramp kernels.
+    if (numChannels == 1)
+        return rampIsMultiplicative
+            ? GainKernels::applyMultiplicativeRamp(block.getChannelPointer(0), numRampSamples, currentGain, rampStep)
+            : GainKernels::applyLinearRamp(block.getChannelPointer(0), numRampSamples, currentGain, rampStep);
+
+    // Otherwise the curve is written once per chunk and shared by all channels.
+    SampleType gain = currentGain;
+    const int chunkSize = (int) gainCurve.size();
+
+    for (int offset = 0; offset < numRampSamples; offset += chunkSize)
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        const int numSamples = juce::jmin(chunkSize, numRampSamples - offset);
+        gain = rampIsMultiplicative ? GainKernels::fillMultiplicativeRamp(gainCurve.data(), numSamples, gain, rampStep)
+                                    : GainKernels::fillLinearRamp(gainCurve.data(), numSamples, gain, rampStep);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer(channel) + offset, gainCurve.data(), numSamples);
+    }
+
+    return gain;
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::process(juce::AudioBuffer<SampleType>& buffer, SampleType gainToApply)
+{
+    process(juce::dsp::AudioBlock<SampleType>(buffer), gainToApply);
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block, SampleType gainToApply)
+{
+    updateTarget(gainToApply);
+    applyGain(block);
+}
+
+template <typename SampleType>
+template <int numSamples>
+void DspProcessor<SampleType>::processFixed(const juce::dsp::AudioBlock<SampleType>& block, SampleType gainToApply)
+{
+    static_assert(numSamples <= (int) std::tuple_size<decltype(gainCurve)>::value, "The ramp of a sub-block must fit into the gain curve");
+    jassert((int) block.getNumSamples() == numSamples);
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+    updateTarget(gainToApply);
+    const auto numChannels = block.getNumChannels();
+
+    if (samplesUntilTarget == 0)
+    {
+        if (currentGain == SampleType(1))
+            return;
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            channelData[i] *= gainToApply;
+            if (currentGain == SampleType(0))
+                juce::FloatVectorOperations::clear(block.getChannelPointer(channel), numSamples);
+            else
+                FixedSizeKernels::multiply<numSamples>(block.getChannelPointer(channel), currentGain);
         }
+
+        return;
+    }
+
+    // A ramp that ends inside the sub-block is rare enough for the general path.
+    if (samplesUntilTarget < numSamples)
+    {
+        applyGain(block);
+        return;
+    }
+
+    const SampleType gainAfterRamp = rampIsMultiplicative
+        ? GainKernels::fillMultiplicativeRamp(gainCurve.data(), numSamples, currentGain, rampStep)
+        : GainKernels::fillLinearRamp(gainCurve.data(), numSamples, currentGain, rampStep);
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        FixedSizeKernels::multiply<numSamples>(block.getChannelPointer(channel), gainCurve.data());
+
+    samplesUntilTarget -= numSamples;
+    currentGain = samplesUntilTarget > 0 ? gainAfterRamp : targetGain;
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::updateTarget(SampleType gainToApply)
+{
+    if (snapToNextGain)
+    {
+        currentGain = targetGain = gainToApply;
+        snapToNextGain = false;
+    }
+    else if (gainToApply != targetGain)
+    {
+        startRamp(gainToApply);
+    }
+}
+
+template <typename SampleType>
+void DspProcessor<SampleType>::applyGain(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    const int numChannels = (int) block.getNumChannels();
+    const int numSamples = (int) block.getNumSamples();
+
+    // Ramp segment: every channel receives the same gain trajectory.
+    const int numRampSamples = juce::jmin(samplesUntilTarget, numSamples);
+
+    if (numRampSamples > 0)
+    {
+        const SampleType gainAfterRamp = applyRamp(block, numRampSamples);
+        samplesUntilTarget -= numRampSamples;
+
+        // Snap exactly onto the target at the end to avoid accumulated rounding.
+        currentGain = samplesUntilTarget > 0 ? gainAfterRamp : targetGain;
     }
+
+    // Settled segment: a plain vectorized multiply, skipped entirely at unity gain.
+    if (const int numSettledSamples = numSamples - numRampSamples; numSettledSamples > 0)
+        for (int channel = 0; channel < numChannels; ++channel)
+            GainKernels::applyConstant(block.getChannelPointer((size_t) channel) + numRampSamples, numSettledSamples, currentGain);
 }
+
+template class DspProcessor<float>;
+template class DspProcessor<double>;
+
+template void DspProcessor<float>::processFixed<32>(const juce::dsp::AudioBlock<float>&, float);
+template void DspProcessor<float>::processFixed<64>(const juce::dsp::AudioBlock<float>&, float);
+template void DspProcessor<double>::processFixed<32>(const juce::dsp::AudioBlock<double>&, double);
+template void DspProcessor<double>::processFixed<64>(const juce::dsp::AudioBlock<double>&, double);
@@ -0,0 +1,85 @@
+#include "pluginTemplateCore/FixedSizeKernels.h"
+#include "pluginTemplateCore/SimdVector.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    template <typename SampleType>
+    using Vector = SimdVector::Vector<SampleType>;
+
+    using SimdVector::loadUnaligned;
+    using SimdVector::storeUnaligned;
+
+    template <int vectorWidth, typename Function, size_t... indices>
+    inline void callForOffsets(Function& function, std::index_sequence<indices...>) noexcept
+    {
+        (function((int) indices * vectorWidth), ...);
+    }
+
+    /** Calls function(offset) for the offset of every register in numSamples samples, expanded at compile time. */
+    template <int numSamples, typename SampleType, typename Function>
+    inline void forEachVector(Function&& function) noexcept
+    {
+        constexpr int vectorWidth = (int) Vector<SampleType>::SIMDNumElements;
+        static_assert(numSamples % vectorWidth == 0, "Sub-block sizes must be a multiple of the SIMD width");
+
+        callForOffsets<vectorWidth>(function, std::make_index_sequence<(size_t) (numSamples / vectorWidth)>());
+    }
+}
+
+template <int numSamples, typename SampleType>
+void FixedSizeKernels::multiply(SampleType* data, SampleType gain) noexcept
+{
+    const auto gains = Vector<SampleType>::expand(gain);
+
+    forEachVector<numSamples, SampleType>([&](int offset)
+    {
+        storeUnaligned(loadUnaligned(data + offset) * gains, data + offset);
+    });
+}
+
+template <int numSamples, typename SampleType>
+void FixedSizeKernels::multiply(SampleType* data, const SampleType* gains) noexcept
+{
+    forEachVector<numSamples, SampleType>([&](int offset)
+    {
+        storeUnaligned(loadUnaligned(data + offset) * loadUnaligned(gains + offset), data + offset);
+    });
+}
+
+template <int numSamples, typename SampleType>
+SampleType FixedSizeKernels::findMagnitude(const SampleType* data) noexcept
+{
+    using SampleVector = Vector<SampleType>;
+    auto magnitudes = SampleVector::expand(0);
+
+    forEachVector<numSamples, SampleType>([&](int offset)
+    {
+        magnitudes = SampleVector::max(magnitudes, SampleVector::abs(loadUnaligned(data + offset)));
+    });
+
+    SampleType lanes[SampleVector::SIMDNumElements];
+    std::memcpy(lanes, &magnitudes, sizeof(lanes));
+
+    SampleType magnitude = 0;
+    for (const auto lane : lanes)
+        magnitude = juce::jmax(magnitude, lane);
+
+    return magnitude;
+}
+
+template void FixedSizeKernels::multiply<32>(float*, float) noexcept;
+template void FixedSizeKernels::multiply<64>(float*, float) noexcept;
+template void FixedSizeKernels::multiply<32>(double*, double) noexcept;
+template void FixedSizeKernels::multiply<64>(double*, double) noexcept;
+template void FixedSizeKernels::multiply<32>(float*, const float*) noexcept;
+template void FixedSizeKernels::multiply<64>(float*, const float*) noexcept;
+template void FixedSizeKernels::multiply<32>(double*, const double*) noexcept;
+template void FixedSizeKernels::multiply<64>(double*, const double*) noexcept;
+template float FixedSizeKernels::findMagnitude<32>(const float*) noexcept;
+template float FixedSizeKernels::findMagnitude<64>(const float*) noexcept;
+template double FixedSizeKernels::findMagnitude<32>(const double*) noexcept;
+template double FixedSizeKernels::findMagnitude<64>(const double*) noexcept;
@@ -0,0 +1,131 @@
+#include "pluginTemplateCore/GainKernels.h"
+
+#include <cmath>
+
+namespace
+{
+    enum class RampShape { linear, multiplicative };
+
+    /** Whether a kernel scales the data by the gain or overwrites it with the gain. */
+    enum class Output { apply, fill };
+
+    template <RampShape shape, typename ValueType>
+    inline ValueType advance(ValueType gain, ValueType step) noexcept
+    {
+        if constexpr (shape == RampShape::multiplicative)
+            return gain * step;
+        else
+            return gain + step;
+    }
+
+    template <Output output, typename ValueType>
+    inline ValueType write(ValueType sample, ValueType gain) noexcept
+    {
+        if constexpr (output == Output::fill)
+            return gain;
+        else
+            return sample * gain;
+    }
+
+    /**
+     * Shared body of the ramp kernels: a scalar head up to the next SIMD
+     * aligned sample, a vectorized body where every lane carries its own gain
+     * and a scalar tail.
+     */
+    template <RampShape shape, Output output, typename SampleType>
+    SampleType processRamp(SampleType* data, int numSamples, SampleType gain, SampleType step) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        using GainVector = juce::dsp::SIMDRegister<SampleType>;
+        constexpr int vectorWidth = (int) GainVector::SIMDNumElements;
+
+        for (; i < numSamples && ! GainVector::isSIMDAligned(data + i); ++i)
+        {
+            data[i] = write<output>(data[i], gain);
+            gain = advance<shape>(gain, step);
+        }
+
+        if (numSamples - i >= vectorWidth)
+        {
+            const auto vectorStep = GainVector::expand(shape == RampShape::multiplicative
+                                                           ? std::pow(step, (SampleType) vectorWidth)
+                                                           : step * (SampleType) vectorWidth);
+            GainVector gains;
+            for (size_t lane = 0; lane < (size_t) vectorWidth; ++lane)
+            {
+                gains.set(lane, gain);
+                gain = advance<shape>(gain, step);
+            }
+
+            for (; i + vectorWidth <= numSamples; i += vectorWidth)
+            {
+                if constexpr (output == Output::fill)
+                    gains.copyToRawArray(data + i);
+                else
+                    (GainVector::fromRawArray(data + i) * gains).copyToRawArray(data + i);
+
+                gains = advance<shape>(gains, vectorStep);
+            }
+
+            gain = gains.get(0);
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            data[i] = write<output>(data[i], gain);
+            gain = advance<shape>(gain, step);
+        }
+
+        return gain;
+    }
+}
+
+template <typename SampleType>
+void GainKernels::applyConstant(SampleType* data, int numSamples, SampleType gain) noexcept
+{
+    if (gain == SampleType(1))
+        return;
+
+    if (gain == SampleType(0))
+        juce::FloatVectorOperations::clear(data, numSamples);
+    else
+        juce::FloatVectorOperations::multiply(data, gain, numSamples);
+}
+
+template <typename SampleType>
+SampleType GainKernels::applyLinearRamp(SampleType* data, int numSamples, SampleType startGain, SampleType increment) noexcept
+{
+    return processRamp<RampShape::linear, Output::apply>(data, numSamples, startGain, increment);
+}
+
+template <typename SampleType>
+SampleType GainKernels::applyMultiplicativeRamp(SampleType* data, int numSamples, SampleType startGain, SampleType ratio) noexcept
+{
+    return processRamp<RampShape::multiplicative, Output::apply>(data, numSamples, startGain, ratio);
+}
+
+template <typename SampleType>
+SampleType GainKernels::fillLinearRamp(SampleType* destination, int numSamples, SampleType startGain, SampleType increment) noexcept
+{
+    return processRamp<RampShape::linear, Output::fill>(destination, numSamples, startGain, increment);
+}
+
+template <typename SampleType>
+SampleType GainKernels::fillMultiplicativeRamp(SampleType* destination, int numSamples, SampleType startGain, SampleType ratio) noexcept
+{
+    return processRamp<RampShape::multiplicative, Output::fill>(destination, numSamples, startGain, ratio);
+}
+
+template void GainKernels::applyConstant(float*, int, float) noexcept;
+template void GainKernels::applyConstant(double*, int, double) noexcept;
+template float GainKernels::applyLinearRamp(float*, int, float, float) noexcept;
+template double GainKernels::applyLinearRamp(double*, int, double, double) noexcept;
+template float GainKernels::applyMultiplicativeRamp(float*, int, float, float) noexcept;
+template double GainKernels::applyMultiplicativeRamp(double*, int, double, double) noexcept;
+template float GainKernels::fillLinearRamp(float*, int, float, float) noexcept;
+template double GainKernels::fillLinearRamp(double*, int, double, double) noexcept;
+template float GainKernels::fillMultiplicativeRamp(float*, int, float, float) noexcept;
+template double GainKernels::fillMultiplicativeRamp(double*, int, double, double) noexcept;
@@ -0,0 +1,176 @@
+#include "pluginTemplateCore/LevelHistory.h"
+
+#include <algorithm>
+
+LevelHistory::LevelHistory()
+{
+    for (auto& level : levels)
+        level.slots = std::vector<Slot>((size_t) capacity);
+}
+
+void LevelHistory::prepare(double sampleRate) noexcept
+{
+    samplesPerPoint = juce::jmax(1, juce::roundToInt(sampleRate * pointSeconds));
+    pointPosition = 0;
+}
+
+void LevelHistory::push(const MeterFrame& frame, int numSamples) noexcept
+{
+    const auto numChannels = juce::jlimit(0, MeterFrame::maxChannels, frame.numChannels);
+    const auto inputLevel = std::max_element(frame.inputLevels.begin(), frame.inputLevels.begin() + numChannels);
+    const auto outputLevel = std::max_element(frame.outputLevels.begin(), frame.outputLevels.begin() + numChannels);
+
+    std::array<float, numQuantities> values {};
+    values[inputPeak] = juce::Decibels::gainToDecibels(numChannels > 0 ? *inputLevel : 0.0f);
+    values[outputPeak] = juce::Decibels::gainToDecibels(numChannels > 0 ? *outputLevel : 0.0f);
+    values[momentaryLoudness] = frame.loudness.momentaryLufs;
+    values[shortTermLoudness] = frame.loudness.shortTermLufs;
+
+    // A block longer than a point fills every point it covers with its readings.
+    for (int remaining = numSamples; remaining > 0;)
+    {
+        for (int q = 0; q < numQuantities; ++q)
+        {
+            current.minimum[(size_t) q] = pointPosition == 0 ? values[(size_t) q] : juce::jmin(current.minimum[(size_t) q], values[(size_t) q]);
+            current.maximum[(size_t) q] = pointPosition == 0 ? values[(size_t) q] : juce::jmax(current.maximum[(size_t) q], values[(size_t) q]);
+        }
+
+        const auto numCovered = juce::jmin(remaining, samplesPerPoint - pointPosition);
+        remaining -= numCovered;
+        pointPosition += numCovered;
+
+        if (pointPosition == samplesPerPoint)
+        {
+            write(0, current);
+            pointPosition = 0;
+        }
+    }
+}
+
+void LevelHistory::write(int levelIndex, const Point& point) noexcept
+{
+    auto& level = levels[(size_t) levelIndex];
+    const auto index = level.numPoints.load(std::memory_order_relaxed);
+    auto& slot = level.slots[(size_t) (index & (capacity - 1))];
+
+    slot.stamp.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.minimum.store(pack(point.minimum), std::memory_order_relaxed);
+    slot.maximum.store(pack(point.maximum), std::memory_order_relaxed);
+
+    slot.stamp.store(2 * index + 2, std::memory_order_release);
+    level.numPoints.store(index + 1, std::memory_order_release);
+
+    if (levelIndex + 1 == numLevels)
+        return;
+
+    if ((index & 1) == 0)
+        level.pending = point;
+    else
+        write(levelIndex + 1, merge(level.pending, point));
+}
+
+LevelHistory::Point LevelHistory::merge(const Point& a, const Point& b) noexcept
+{
+    Point merged;
+
+    for (size_t q = 0; q < (size_t) numQuantities; ++q)
+    {
+        merged.minimum[q] = juce::jmin(a.minimum[q], b.minimum[q]);
+        merged.maximum[q] = juce::jmax(a.maximum[q], b.maximum[q]);
+    }
+
+    return merged;
+}
+
+juce::uint64 LevelHistory::pack(const std::array<float, numQuantities>& values) noexcept
+{
+    static_assert(numQuantities * 16 <= 64, "The quantities of a point must fit into 64 bits");
+
+    juce::uint64 packed = 0;
+
+    for (int q = 0; q < numQuantities; ++q)
+    {
+        // -inf from silence ends up at the bottom of the range, about -328 dB.
+        const auto hundredths = juce::roundToInt(juce::jlimit(-327.68f, 327.67f, values[(size_t) q]) * 100.0f);
+        packed |= (juce::uint64) (juce::uint16) (juce::int16) hundredths << (16 * q);
+    }
+
+    return packed;
+}
+
+std::array<float, LevelHistory::numQuantities> LevelHistory::unpack(juce::uint64 packed) noexcept
+{
+    std::array<float, numQuantities> values;
+
+    for (int q = 0; q < numQuantities; ++q)
+        values[(size_t) q] = (float) (juce::int16) (juce::uint16) (packed >> (16 * q)) / 100.0f;
+
+    return values;
+}
+
+juce::uint64 LevelHistory::getNumPoints(int level) const noexcept
+{
+    if (! juce::isPositiveAndBelow(level, numLevels))
+        return 0;
+
+    return levels[(size_t) level].numPoints.load(std::memory_order_acquire);
+}
+
+int LevelHistory::copyPoints(int levelIndex, juce::uint64 since, Point* destination, int maxPoints, juce::uint64& firstIndex) const noexcept
+{
+    firstIndex = since;
+
+    if (! juce::isPositiveAndBelow(levelIndex, numLevels) || maxPoints <= 0)
+        return 0;
+
+    const auto& level = levels[(size_t) levelIndex];
+    const auto numPoints = level.numPoints.load(std::memory_order_acquire);
+
+    if (since >= numPoints)
+        return 0;
+
+    // The oldest point may be overwritten while it is read, which the stamps catch.
+    firstIndex = juce::jmax(since, numPoints > (juce::uint64) capacity ? numPoints - (juce::uint64) capacity : 0);
+    int numCopied = 0;
+
+    for (auto index = firstIndex; index < numPoints && numCopied < maxPoints; ++index)
+    {
+        const auto& slot = level.slots[(size_t) (index & (capacity - 1))];
+        const auto stamp = slot.stamp.load(std::memory_order_acquire);
+
+        if (stamp != 2 * index + 2)
+        {
+            // Overwritten by a newer point before it could be read: skip past it.
+            if (numCopied == 0)
+            {
+                firstIndex = index + 1;
+                continue;
+            }
+
+            break;
+        }
+
+        auto& point = destination[numCopied];
+        point.minimum = unpack(slot.minimum.load(std::memory_order_relaxed));
+        point.maximum = unpack(slot.maximum.load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.stamp.load(std::memory_order_relaxed) != stamp)
+        {
+            if (numCopied == 0)
+            {
+                firstIndex = index + 1;
+                continue;
+            }
+
+            break;
+        }
+
+        ++numCopied;
+    }
+
+    return numCopied;
+}
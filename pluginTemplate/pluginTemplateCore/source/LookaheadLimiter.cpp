@@ -0,0 +1,156 @@
+#include "pluginTemplateCore/LookaheadLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, float lookaheadMs)
+{
+    sampleRate = spec.sampleRate;
+    numChannels = (int) spec.numChannels;
+    lookaheadSamples = juce::jmax(0, juce::roundToInt(sampleRate * lookaheadMs / 1000.0));
+    windowLength = lookaheadSamples + 1;
+
+    dequeGains.assign((size_t) windowLength, SampleType(1));
+    dequeSampleIndices.assign((size_t) windowLength, 0);
+    averageHistory.assign((size_t) windowLength, SampleType(1));
+    delayLines.assign((size_t) (numChannels * lookaheadSamples), SampleType(0));
+
+    reset();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setParameters(float ceilingDb, float releaseMs) noexcept
+{
+    ceilingGain = juce::Decibels::decibelsToGain((SampleType) ceilingDb);
+    releaseCoefficient = (SampleType) std::exp(-1000.0 / (juce::jmax(1.0f, releaseMs) * sampleRate));
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::reset() noexcept
+{
+    dequeHead = 0;
+    dequeSize = 0;
+    sampleIndex = 0;
+    envelope = 1;
+
+    std::fill(averageHistory.begin(), averageHistory.end(), SampleType(1));
+    averagePosition = 0;
+    averageSum = (double) windowLength;
+
+    std::fill(delayLines.begin(), delayLines.end(), SampleType(0));
+    delayPosition = 0;
+    lastBlockMinimumGain = 1.0f;
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    jassert((int) block.getNumChannels() <= numChannels);
+
+    const auto numSamples = (int) block.getNumSamples();
+    lastBlockMinimumGain = 1.0f;
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        const auto numChunkSamples = juce::jmin(chunkSize, numSamples - offset);
+
+        computeGainCurve(block, (size_t) offset, numChunkSamples);
+        delayChannels(block, (size_t) offset, numChunkSamples);
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer(channel) + offset, gainCurve.data(), numChunkSamples);
+
+        lastBlockMinimumGain = juce::jmin(lastBlockMinimumGain,
+                                          (float) juce::FloatVectorOperations::findMinimum(gainCurve.data(), numChunkSamples));
+    }
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::computeGainCurve(const juce::dsp::AudioBlock<SampleType>& block, size_t offset, int numSamples) noexcept
+{
+    // The loudest channel per sample, vectorized.
+    std::fill(peakCurve.begin(), peakCurve.begin() + numSamples, SampleType(0));
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        juce::FloatVectorOperations::abs(channelMagnitudes.data(), block.getChannelPointer(channel) + offset, numSamples);
+        juce::FloatVectorOperations::max(peakCurve.data(), peakCurve.data(), channelMagnitudes.data(), numSamples);
+    }
+
+    const auto invWindowLength = 1.0 / (double) windowLength;
+
+    for (int i = 0; i < numSamples; ++i, ++sampleIndex)
+    {
+        const auto peak = peakCurve[(size_t) i];
+        const auto requiredGain = peak > ceilingGain ? ceilingGain / peak : SampleType(1);
+
+        // Sliding minimum: the entry that left the window leaves from the front,
+        // entries that can no longer be the minimum from the back.
+        if (dequeSize > 0 && dequeSampleIndices[(size_t) dequeHead] <= sampleIndex - windowLength)
+        {
+            dequeHead = dequeHead + 1 == windowLength ? 0 : dequeHead + 1;
+            --dequeSize;
+        }
+
+        while (dequeSize > 0)
+        {
+            const auto back = (dequeHead + dequeSize - 1) % windowLength;
+            if (dequeGains[(size_t) back] < requiredGain)
+                break;
+            --dequeSize;
+        }
+
+        const auto tail = (dequeHead + dequeSize) % windowLength;
+        dequeGains[(size_t) tail] = requiredGain;
+        dequeSampleIndices[(size_t) tail] = sampleIndex;
+        ++dequeSize;
+
+        const auto heldGain = dequeGains[(size_t) dequeHead];
+
+        envelope = heldGain < envelope ? heldGain : heldGain + (envelope - heldGain) * releaseCoefficient;
+
+        averageSum += (double) envelope - (double) averageHistory[(size_t) averagePosition];
+        averageHistory[(size_t) averagePosition] = envelope;
+        averagePosition = averagePosition + 1 == windowLength ? 0 : averagePosition + 1;
+
+        // The clamp keeps rounding in the running sum from ever turning into a boost.
+        gainCurve[(size_t) i] = (SampleType) juce::jmin(1.0, averageSum * invWindowLength);
+    }
+
+    // Resumming whenever the history wrapped keeps rounding errors from accumulating.
+    // It happens at most once per chunk and at most once per window, so it stays O(1) per sample.
+    if (averagePosition < numSamples)
+        averageSum = std::accumulate(averageHistory.begin(), averageHistory.end(), 0.0);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::delayChannels(const juce::dsp::AudioBlock<SampleType>& block, size_t offset, int numSamples) noexcept
+{
+    if (lookaheadSamples == 0)
+        return;
+
+    // Swapping the block with the ring reads the delayed samples and stores the new ones in one pass.
+    int position = delayPosition;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto numSegmentSamples = juce::jmin(numSamples - done, lookaheadSamples - position);
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto* samples = block.getChannelPointer(channel) + offset + (size_t) done;
+            auto* ring = delayLines.data() + channel * (size_t) lookaheadSamples + (size_t) position;
+            std::swap_ranges(samples, samples + numSegmentSamples, ring);
+        }
+
+        done += numSegmentSamples;
+        position = (position + numSegmentSamples) % lookaheadSamples;
+    }
+
+    delayPosition = position;
+}
+
+template class LookaheadLimiter<float>;
+template class LookaheadLimiter<double>;
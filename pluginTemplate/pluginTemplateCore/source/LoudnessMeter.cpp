@@ -0,0 +1,387 @@
+#include "pluginTemplateCore/LoudnessMeter.h"
+#include "pluginTemplateCore/SimdVector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using Vector = SimdVector::Vector<double>;
+
+    using SimdVector::loadUnaligned;
+    using SimdVector::storeUnaligned;
+
+    constexpr int vectorWidth = (int) Vector::SIMDNumElements;
+    constexpr int vectorsPerGroup = 5;
+
+    float powerToLufs(double power) noexcept
+    {
+        return power > 0.0 ? juce::jmax(LoudnessMeter::silenceLufs, (float) (-0.691 + 10.0 * std::log10(power)))
+                           : LoudnessMeter::silenceLufs;
+    }
+
+    double getChannelWeight(const juce::AudioChannelSet& channelSet, int channel)
+    {
+        using ChannelType = juce::AudioChannelSet::ChannelType;
+
+        if (channelSet.getAmbisonicOrder() >= 0)
+            return channel == 0 ? 1.0 : 0.0;
+
+        switch (channelSet.getTypeOfChannel(channel))
+        {
+            case ChannelType::LFE:
+            case ChannelType::LFE2:
+                return 0.0;
+
+            case ChannelType::leftSurround:
+            case ChannelType::rightSurround:
+            case ChannelType::leftSurroundSide:
+            case ChannelType::rightSurroundSide:
+                return 1.41;
+
+            default:
+                return 1.0;
+        }
+    }
+}
+
+//==============================================================================
+int LoudnessMeter::LoudnessHistogram::getBin(float lufs) noexcept
+{
+    return juce::jlimit(0, numBins - 1, (int) std::floor((lufs - absoluteGateLufs) / histogramBinWidthLu));
+}
+
+float LoudnessMeter::LoudnessHistogram::getBinCentreLufs(int bin) noexcept
+{
+    return absoluteGateLufs + ((float) bin + 0.5f) * histogramBinWidthLu;
+}
+
+void LoudnessMeter::LoudnessHistogram::add(double power) noexcept
+{
+    const auto lufs = powerToLufs(power);
+
+    if (lufs < absoluteGateLufs)
+        return;
+
+    const auto bin = (size_t) getBin(lufs);
+    ++counts[bin];
+    powers[bin] += power;
+    ++totalCount;
+    totalPower += power;
+}
+
+void LoudnessMeter::LoudnessHistogram::clear() noexcept
+{
+    counts.fill(0);
+    powers.fill(0.0);
+    totalCount = 0;
+    totalPower = 0.0;
+}
+
+double LoudnessMeter::LoudnessHistogram::getMeanPower(int firstBin) const noexcept
+{
+    juce::uint64 count = 0;
+    double power = 0.0;
+
+    for (auto bin = (size_t) firstBin; bin < (size_t) numBins; ++bin)
+    {
+        count += counts[bin];
+        power += powers[bin];
+    }
+
+    return count > 0 ? power / (double) count : 0.0;
+}
+
+float LoudnessMeter::LoudnessHistogram::getPercentileLufs(int firstBin, double fraction) const noexcept
+{
+    juce::uint64 count = 0;
+    for (auto bin = (size_t) firstBin; bin < (size_t) numBins; ++bin)
+        count += counts[bin];
+
+    const auto target = (juce::uint64) std::ceil(fraction * (double) count);
+    juce::uint64 cumulative = 0;
+
+    for (int bin = firstBin; bin < numBins; ++bin)
+    {
+        cumulative += counts[(size_t) bin];
+        if (cumulative >= juce::jmax((juce::uint64) 1, target))
+            return getBinCentreLufs(bin);
+    }
+
+    return getBinCentreLufs(numBins - 1);
+}
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter() = default;
+
+void LoudnessMeter::prepare(const juce::dsp::ProcessSpec& spec, const juce::AudioChannelSet& channelSet)
+{
+    numChannels = (int) spec.numChannels;
+    numChannelGroups = (numChannels + vectorWidth - 1) / vectorWidth;
+    subBlockLength = juce::jmax(1, juce::roundToInt(spec.sampleRate * subBlockSeconds));
+
+    channelWeights.assign((size_t) (numChannelGroups * vectorWidth), 0.0);
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelWeights[(size_t) channel] = channelSet.size() == numChannels ? getChannelWeight(channelSet, channel) : 1.0;
+
+    filterState.assign((size_t) (numChannelGroups * vectorsPerGroup * vectorWidth), 0.0);
+
+    // K-weighting for any sample rate, from the analog prototypes of the
+    // BS.1770 48 kHz coefficients. Stage 1 is the high-shelf pre-filter,
+    // stage 2 the RLB high-pass.
+    const auto pi = juce::MathConstants<double>::pi;
+    {
+        constexpr double f0 = 1681.974450955533;
+        constexpr double gainDb = 3.999843853973347;
+        constexpr double q = 0.7071752369554196;
+
+        const auto k = std::tan(pi * f0 / spec.sampleRate);
+        const auto vh = std::pow(10.0, gainDb / 20.0);
+        const auto vb = std::pow(vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        coefficients[0] = (vh + vb * k / q + k * k) / a0;
+        coefficients[1] = 2.0 * (k * k - vh) / a0;
+        coefficients[2] = (vh - vb * k / q + k * k) / a0;
+        coefficients[3] = 2.0 * (k * k - 1.0) / a0;
+        coefficients[4] = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        constexpr double f0 = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+
+        const auto k = std::tan(pi * f0 / spec.sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        coefficients[5] = 1.0;
+        coefficients[6] = -2.0;
+        coefficients[7] = 1.0;
+        coefficients[8] = 2.0 * (k * k - 1.0) / a0;
+        coefficients[9] = (1.0 - k / q + k * k) / a0;
+    }
+
+    reset();
+}
+
+void LoudnessMeter::reset() noexcept
+{
+    std::fill(filterState.begin(), filterState.end(), 0.0);
+    subBlockPosition = 0;
+    subBlockPowers.fill(0.0);
+    subBlockIndex = 0;
+    numSubBlocks = 0;
+    momentarySum = 0.0;
+    shortTermSum = 0.0;
+
+    momentaryLufs.store(silenceLufs, std::memory_order_relaxed);
+    shortTermLufs.store(silenceLufs, std::memory_order_relaxed);
+    clearIntegration();
+}
+
+void LoudnessMeter::clearIntegration() noexcept
+{
+    integratedHistogram.clear();
+    rangeHistogram.clear();
+    integratedLufs.store(silenceLufs, std::memory_order_relaxed);
+    loudnessRangeLu.store(0.0f, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::process(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    processSamples(juce::dsp::AudioBlock<const float>(buffer));
+}
+
+void LoudnessMeter::process(const juce::AudioBuffer<double>& buffer) noexcept
+{
+    processSamples(juce::dsp::AudioBlock<const double>(buffer));
+}
+
+void LoudnessMeter::process(const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    processSamples(block);
+}
+
+void LoudnessMeter::process(const juce::dsp::AudioBlock<const double>& block) noexcept
+{
+    processSamples(block);
+}
+
+template <typename SampleType>
+void LoudnessMeter::processSamples(const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_relaxed))
+        clearIntegration();
+
+    jassert((int) block.getNumChannels() >= numChannels);
+
+    const auto numSamples = (int) block.getNumSamples();
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto numToProcess = juce::jmin(numSamples - offset, subBlockLength - subBlockPosition);
+        filterAndAccumulate(block, offset, numToProcess);
+
+        offset += numToProcess;
+        subBlockPosition += numToProcess;
+
+        if (subBlockPosition == subBlockLength)
+        {
+            finishSubBlock();
+            subBlockPosition = 0;
+        }
+    }
+}
+
+void LoudnessMeter::processSilence(int numSamples) noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_relaxed))
+        clearIntegration();
+
+    // Only the biquad states are cleared; the energy of the current sub-block stays.
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        auto* state = filterState.data() + group * vectorsPerGroup * vectorWidth;
+        std::fill(state, state + 4 * vectorWidth, 0.0);
+    }
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto numToSkip = juce::jmin(numSamples - offset, subBlockLength - subBlockPosition);
+
+        offset += numToSkip;
+        subBlockPosition += numToSkip;
+
+        if (subBlockPosition == subBlockLength)
+        {
+            finishSubBlock();
+            subBlockPosition = 0;
+        }
+    }
+}
+
+template <typename SampleType>
+void LoudnessMeter::filterAndAccumulate(const juce::dsp::AudioBlock<const SampleType>& block, int startSample, int numSamples) noexcept
+{
+    const auto b10 = Vector::expand(coefficients[0]), b11 = Vector::expand(coefficients[1]), b12 = Vector::expand(coefficients[2]);
+    const auto a11 = Vector::expand(coefficients[3]), a12 = Vector::expand(coefficients[4]);
+    const auto b20 = Vector::expand(coefficients[5]), b21 = Vector::expand(coefficients[6]), b22 = Vector::expand(coefficients[7]);
+    const auto a21 = Vector::expand(coefficients[8]), a22 = Vector::expand(coefficients[9]);
+
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        const auto firstChannel = group * vectorWidth;
+        const auto numLanes = juce::jmin(vectorWidth, numChannels - firstChannel);
+
+        const SampleType* lanePointers[vectorWidth] {};
+        for (int lane = 0; lane < numLanes; ++lane)
+            lanePointers[lane] = block.getChannelPointer((size_t) (firstChannel + lane)) + startSample;
+
+        auto* state = filterState.data() + group * vectorsPerGroup * vectorWidth;
+        auto s11 = loadUnaligned(state);
+        auto s12 = loadUnaligned(state + vectorWidth);
+        auto s21 = loadUnaligned(state + 2 * vectorWidth);
+        auto s22 = loadUnaligned(state + 3 * vectorWidth);
+        auto energy = loadUnaligned(state + 4 * vectorWidth);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Unused lanes stay at zero, so they add nothing to the energy.
+            double laneSamples[vectorWidth] {};
+            for (int lane = 0; lane < numLanes; ++lane)
+                laneSamples[lane] = lanePointers[lane][i];
+
+            const auto x = loadUnaligned(laneSamples);
+
+            // Two transposed direct form II biquads.
+            const auto y1 = b10 * x + s11;
+            s11 = b11 * x - a11 * y1 + s12;
+            s12 = b12 * x - a12 * y1;
+
+            const auto y2 = b20 * y1 + s21;
+            s21 = b21 * y1 - a21 * y2 + s22;
+            s22 = b22 * y1 - a22 * y2;
+
+            energy += y2 * y2;
+        }
+
+        storeUnaligned(s11, state);
+        storeUnaligned(s12, state + vectorWidth);
+        storeUnaligned(s21, state + 2 * vectorWidth);
+        storeUnaligned(s22, state + 3 * vectorWidth);
+        storeUnaligned(energy, state + 4 * vectorWidth);
+    }
+}
+
+void LoudnessMeter::finishSubBlock() noexcept
+{
+    double power = 0.0;
+
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        auto* energy = filterState.data() + (group * vectorsPerGroup + 4) * vectorWidth;
+
+        for (int lane = 0; lane < vectorWidth; ++lane)
+            power += channelWeights[(size_t) (group * vectorWidth + lane)] * energy[lane];
+
+        std::fill(energy, energy + vectorWidth, 0.0);
+    }
+
+    power /= (double) subBlockLength;
+
+    // Running window sums: add the newest sub-block, drop the one that left the window.
+    const auto momentaryExpired = (subBlockIndex + shortTermSubBlocks - momentarySubBlocks) % shortTermSubBlocks;
+    momentarySum += power - subBlockPowers[(size_t) momentaryExpired];
+    shortTermSum += power - subBlockPowers[(size_t) subBlockIndex];
+    subBlockPowers[(size_t) subBlockIndex] = power;
+    subBlockIndex = (subBlockIndex + 1) % shortTermSubBlocks;
+    ++numSubBlocks;
+
+    // Resumming once per ring cycle keeps rounding errors from accumulating over long sessions.
+    if (subBlockIndex == 0)
+    {
+        momentarySum = shortTermSum = 0.0;
+
+        for (int i = 0; i < shortTermSubBlocks; ++i)
+        {
+            shortTermSum += subBlockPowers[(size_t) i];
+            if (i >= shortTermSubBlocks - momentarySubBlocks)
+                momentarySum += subBlockPowers[(size_t) i];
+        }
+    }
+
+    const auto momentaryPower = juce::jmax(0.0, momentarySum) / momentarySubBlocks;
+    const auto shortTermPower = juce::jmax(0.0, shortTermSum) / shortTermSubBlocks;
+
+    momentaryLufs.store(powerToLufs(momentaryPower), std::memory_order_relaxed);
+    shortTermLufs.store(powerToLufs(shortTermPower), std::memory_order_relaxed);
+
+    // Gating blocks are 400 ms with 75 % overlap and short-term values are
+    // taken every 100 ms, so both histograms get one entry per full window.
+    if (numSubBlocks >= momentarySubBlocks)
+        integratedHistogram.add(momentaryPower);
+
+    if (numSubBlocks >= shortTermSubBlocks)
+        rangeHistogram.add(shortTermPower);
+
+    publishGatedReadings();
+}
+
+void LoudnessMeter::publishGatedReadings() noexcept
+{
+    if (integratedHistogram.totalCount > 0)
+    {
+        const auto ungatedPower = integratedHistogram.totalPower / (double) integratedHistogram.totalCount;
+        const auto gateBin = LoudnessHistogram::getBin(powerToLufs(ungatedPower) + integratedRelativeGateLu);
+        integratedLufs.store(powerToLufs(integratedHistogram.getMeanPower(gateBin)), std::memory_order_relaxed);
+    }
+
+    if (rangeHistogram.totalCount > 0)
+    {
+        // EBU Tech 3342: the spread between the 10th and 95th percentile of the gated short-term loudness.
+        const auto ungatedPower = rangeHistogram.totalPower / (double) rangeHistogram.totalCount;
+        const auto gateBin = LoudnessHistogram::getBin(powerToLufs(ungatedPower) + rangeRelativeGateLu);
+        const auto low = rangeHistogram.getPercentileLufs(gateBin, 0.10);
+        const auto high = rangeHistogram.getPercentileLufs(gateBin, 0.95);
+        loudnessRangeLu.store(high - low, std::memory_order_relaxed);
+    }
+}
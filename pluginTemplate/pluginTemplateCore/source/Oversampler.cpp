@@ -0,0 +1,516 @@
+#include "pluginTemplateCore/Oversampler.h"
+#include "pluginTemplateCore/SimdVector.h"
+
+#include <cmath>
+
+namespace
+{
+    using Vector = SimdVector::Vector<float>;
+
+    using SimdVector::loadUnaligned;
+    using SimdVector::storeUnaligned;
+
+    constexpr int vectorWidth = (int) Vector::SIMDNumElements;
+
+    int roundUpToVectorWidth(int numSamples) noexcept
+    {
+        return (numSamples + vectorWidth - 1) / vectorWidth * vectorWidth;
+    }
+
+    /**
+     * destination[i] = sum over j of coefficients[j] * source[i - j], so source
+     * must be preceded by coefficients.size() - 1 samples of history. Vectors
+     * run over i and may read and write up to vectorWidth - 1 samples past
+     * numSamples, which both buffers must have room for.
+     */
+    void convolve(const float* source, const std::vector<Vector>& coefficients,
+                  float* destination, int numSamples) noexcept
+    {
+        const auto numTaps = coefficients.size();
+
+        for (int i = 0; i < numSamples; i += vectorWidth)
+        {
+            auto sum = Vector::expand(0.0f);
+
+            for (size_t j = 0; j < numTaps; ++j)
+                sum += loadUnaligned(source + i - (int) j) * coefficients[j];
+
+            storeUnaligned(sum, destination + i);
+        }
+    }
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; term > 1.0e-12 * sum; ++k)
+        {
+            term *= juce::square(x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    /**
+     * The non-trivial taps h[0], h[2], ... of a Kaiser windowed half-band FIR
+     * with 2 * numBranchTaps - 1 taps (numBranchTaps must be even), scaled so
+     * they sum to one. The centre tap is 0.5 and all other odd taps are zero.
+     */
+    std::vector<double> designHalfBandFir(int numBranchTaps, double attenuationDb)
+    {
+        const int numTaps = 2 * numBranchTaps - 1;
+        const int centre = (numTaps - 1) / 2;
+        const double beta = 0.1102 * (attenuationDb - 8.7);
+
+        std::vector<double> branch ((size_t) numBranchTaps);
+        double sum = 0.0;
+
+        for (int j = 0; j < numBranchTaps; ++j)
+        {
+            const int offset = 2 * j - centre;
+            const double x = juce::MathConstants<double>::halfPi * offset;
+            const double position = (double) (2 * j) / (numTaps - 1) * 2.0 - 1.0;
+            const double window = besselI0(beta * std::sqrt(1.0 - position * position)) / besselI0(beta);
+
+            branch[(size_t) j] = std::sin(x) / x * window;
+            sum += branch[(size_t) j];
+        }
+
+        for (auto& tap : branch)
+            tap /= sum;
+
+        return branch;
+    }
+
+    /**
+     * Allpass coefficients of a polyphase IIR half-band filter, after Laurent
+     * de Soras' HIIR designer: an elliptic prototype whose order follows from
+     * the stopband attenuation and the transition bandwidth (relative to the
+     * higher sample rate). The order is rounded up to an even coefficient
+     * count, so both branches get the same number of sections.
+     */
+    std::vector<double> designHalfBandPolyphaseIir(double attenuationDb, double transitionBandwidth)
+    {
+        const double pi = juce::MathConstants<double>::pi;
+
+        double k = std::tan((1.0 - transitionBandwidth * 2.0) * pi / 4.0);
+        k *= k;
+        const double kRoot = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kRoot) / (1.0 + kRoot);
+        const double e4 = std::pow(e, 4.0);
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const double attenuation = std::pow(10.0, -attenuationDb / 10.0);
+        const double a = attenuation / (1.0 - attenuation);
+        int order = (int) std::ceil(std::log(a * a / 16.0) / std::log(q));
+        order = juce::jmax(5, order);
+
+        while (order % 4 != 1)
+            ++order;
+
+        std::vector<double> coefficients ((size_t) (order - 1) / 2);
+
+        for (size_t index = 0; index < coefficients.size(); ++index)
+        {
+            const int c = (int) index + 1;
+
+            double numerator = 0.0, term = 0.0;
+            for (int i = 0, sign = 1; i == 0 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * pi / order) * sign;
+                numerator += term;
+            }
+
+            double denominator = 0.0;
+            for (int i = 1, sign = -1; i == 1 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = std::pow(q, i * i) * std::cos(i * 2 * c * pi / order) * sign;
+                denominator += term;
+            }
+
+            const double ww = numerator * std::pow(q, 0.25) / (denominator + 0.5);
+            const double wwSquared = ww * ww;
+            const double x = std::sqrt((1.0 - wwSquared * k) * (1.0 - wwSquared / k)) / (1.0 + wwSquared);
+            coefficients[index] = (1.0 - x) / (1.0 + x);
+        }
+
+        return coefficients;
+    }
+}
+
+//==============================================================================
+/** One factor of two: upsampling into its own buffer and downsampling back out of it. */
+class Oversampler::Stage
+{
+public:
+    virtual ~Stage() = default;
+
+    /** maxInputSamples is at the rate this stage upsamples from. */
+    void prepare(int numChannels, int maxInputSamples)
+    {
+        upsampled.setSize(numChannels, 2 * maxInputSamples);
+        allocate(numChannels, maxInputSamples);
+        reset();
+    }
+
+    virtual void reset() noexcept = 0;
+
+    /** Writes 2 * input.getNumSamples() samples per channel to upsampled. */
+    virtual void processUp(const juce::dsp::AudioBlock<const float>& input) noexcept = 0;
+
+    /** Reads 2 * output.getNumSamples() samples per channel from upsampled. */
+    virtual void processDown(juce::dsp::AudioBlock<float>& output) noexcept = 0;
+
+    /** The round trip delay in samples at the rate this stage upsamples from. */
+    [[nodiscard]] virtual float getLatency() const noexcept = 0;
+
+    juce::AudioBuffer<float> upsampled;
+
+protected:
+    virtual void allocate(int numChannels, int maxInputSamples) = 0;
+};
+
+//==============================================================================
+/**
+ * Upsampling: the even outputs are the input filtered by the even taps, the
+ * odd outputs are the input delayed to the centre tap. Downsampling is the
+ * transpose. Each channel keeps its history in front of the block it is
+ * working on, so the kernels never need to wrap around.
+ */
+class Oversampler::FirStage final : public Stage
+{
+public:
+    FirStage(int numBranchTapsToUse, double attenuationDb)
+        : numBranchTaps(numBranchTapsToUse),
+          historySize(numBranchTapsToUse - 1)
+    {
+        for (auto tap : designHalfBandFir(numBranchTaps, attenuationDb))
+        {
+            upCoefficients.push_back(Vector::expand((float) tap));
+            downCoefficients.push_back(Vector::expand((float) (0.5 * tap)));
+        }
+    }
+
+    void reset() noexcept override
+    {
+        upInput.clear();
+        downEven.clear();
+        downOdd.clear();
+    }
+
+    void processUp(const juce::dsp::AudioBlock<const float>& input) noexcept override
+    {
+        const int numSamples = (int) input.getNumSamples();
+        auto* evenOutputs = scratch.getWritePointer(0);
+
+        for (int channel = 0; channel < upInput.getNumChannels(); ++channel)
+        {
+            auto* history = upInput.getWritePointer(channel);
+            auto* source = history + historySize;
+            juce::FloatVectorOperations::copy(source, input.getChannelPointer((size_t) channel), numSamples);
+
+            convolve(source, upCoefficients, evenOutputs, numSamples);
+
+            // The centre tap (0.5, doubled for the zero stuffing) is half a branch behind.
+            const auto* delayed = source - (numBranchTaps / 2 - 1);
+            auto* destination = upsampled.getWritePointer(channel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                destination[2 * i] = evenOutputs[i];
+                destination[2 * i + 1] = delayed[i];
+            }
+
+            juce::FloatVectorOperations::copy(history, history + numSamples, historySize);
+        }
+    }
+
+    void processDown(juce::dsp::AudioBlock<float>& output) noexcept override
+    {
+        const int numSamples = (int) output.getNumSamples();
+        const int oddHistorySize = numBranchTaps / 2;
+        auto* filtered = scratch.getWritePointer(0);
+
+        for (int channel = 0; channel < downEven.getNumChannels(); ++channel)
+        {
+            const auto* source = upsampled.getReadPointer(channel);
+            auto* evenHistory = downEven.getWritePointer(channel);
+            auto* oddHistory = downOdd.getWritePointer(channel);
+            auto* even = evenHistory + historySize;
+            auto* odd = oddHistory + oddHistorySize;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                even[i] = source[2 * i];
+                odd[i] = source[2 * i + 1];
+            }
+
+            convolve(even, downCoefficients, filtered, numSamples);
+
+            auto* destination = output.getChannelPointer((size_t) channel);
+            juce::FloatVectorOperations::copy(destination, filtered, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(destination, oddHistory, 0.5f, numSamples);
+
+            juce::FloatVectorOperations::copy(evenHistory, evenHistory + numSamples, historySize);
+            juce::FloatVectorOperations::copy(oddHistory, oddHistory + numSamples, oddHistorySize);
+        }
+    }
+
+    float getLatency() const noexcept override
+    {
+        // Half the filter length at the higher rate, once on the way up and once on the way down.
+        return (float) (numBranchTaps - 1);
+    }
+
+private:
+    void allocate(int numChannels, int maxInputSamples) override
+    {
+        // Vector kernels may run up to vectorWidth - 1 samples past the end of a block.
+        const int paddedSize = roundUpToVectorWidth(maxInputSamples) + vectorWidth;
+
+        upInput.setSize(numChannels, historySize + paddedSize);
+        downEven.setSize(numChannels, historySize + paddedSize);
+        downOdd.setSize(numChannels, numBranchTaps / 2 + paddedSize);
+        scratch.setSize(1, paddedSize);
+        scratch.clear();
+    }
+
+    const int numBranchTaps;
+    const int historySize;
+    std::vector<Vector> upCoefficients, downCoefficients;
+    juce::AudioBuffer<float> upInput, downEven, downOdd, scratch;
+};
+
+//==============================================================================
+/**
+ * The allpass recursion cannot be vectorized over time, so each SIMD register
+ * holds both branches of vectorWidth / 2 channels: lanes 2c and 2c + 1 run
+ * the even and odd numbered coefficients for channel c of the group.
+ */
+class Oversampler::IirStage final : public Stage
+{
+public:
+    IirStage(double attenuationDb, double transitionBandwidth)
+    {
+        const auto design = designHalfBandPolyphaseIir(attenuationDb, transitionBandwidth);
+        numSections = (int) design.size() / 2;
+
+        for (int section = 0; section < numSections; ++section)
+        {
+            alignas(16) float lanes[vectorWidth];
+
+            for (int lane = 0; lane < vectorWidth; ++lane)
+                lanes[lane] = (float) design[(size_t) (2 * section + lane % 2)];
+
+            coefficients.push_back(loadUnaligned(lanes));
+
+            // Group delay at DC of (a + z^-1) / (1 + a z^-1), in samples at the lower rate.
+            branchDelays[0] += (1.0 - design[(size_t) (2 * section)]) / (1.0 + design[(size_t) (2 * section)]);
+            branchDelays[1] += (1.0 - design[(size_t) (2 * section + 1)]) / (1.0 + design[(size_t) (2 * section + 1)]);
+        }
+    }
+
+    void reset() noexcept override
+    {
+        std::fill(upState.begin(), upState.end(), Vector::expand(0.0f));
+        std::fill(downState.begin(), downState.end(), Vector::expand(0.0f));
+    }
+
+    void processUp(const juce::dsp::AudioBlock<const float>& input) noexcept override
+    {
+        const int numSamples = (int) input.getNumSamples();
+        alignas(16) float lanes[vectorWidth] {};
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            auto* state = upState.data() + group * 2 * numSections;
+            const int firstChannel = group * channelsPerGroup;
+            const int numGroupChannels = juce::jmin(channelsPerGroup, upsampled.getNumChannels() - firstChannel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int c = 0; c < numGroupChannels; ++c)
+                    lanes[2 * c] = lanes[2 * c + 1] = input.getChannelPointer((size_t) (firstChannel + c))[i];
+
+                storeUnaligned(processSections(loadUnaligned(lanes), state), lanes);
+
+                for (int c = 0; c < numGroupChannels; ++c)
+                {
+                    auto* destination = upsampled.getWritePointer(firstChannel + c);
+                    destination[2 * i] = lanes[2 * c];
+                    destination[2 * i + 1] = lanes[2 * c + 1];
+                }
+            }
+        }
+    }
+
+    void processDown(juce::dsp::AudioBlock<float>& output) noexcept override
+    {
+        const int numSamples = (int) output.getNumSamples();
+        alignas(16) float lanes[vectorWidth] {};
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            auto* state = downState.data() + group * 2 * numSections;
+            const int firstChannel = group * channelsPerGroup;
+            const int numGroupChannels = juce::jmin(channelsPerGroup, upsampled.getNumChannels() - firstChannel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int c = 0; c < numGroupChannels; ++c)
+                {
+                    const auto* source = upsampled.getReadPointer(firstChannel + c);
+                    lanes[2 * c] = source[2 * i + 1];
+                    lanes[2 * c + 1] = source[2 * i];
+                }
+
+                storeUnaligned(processSections(loadUnaligned(lanes), state), lanes);
+
+                for (int c = 0; c < numGroupChannels; ++c)
+                    output.getChannelPointer((size_t) (firstChannel + c))[i] = 0.5f * (lanes[2 * c] + lanes[2 * c + 1]);
+            }
+        }
+    }
+
+    float getLatency() const noexcept override
+    {
+        // At the higher rate the upsampler delays by the mean of both branches
+        // plus half a sample, the downsampler by the mean minus half a sample.
+        return (float) (branchDelays[0] + branchDelays[1]);
+    }
+
+private:
+    void allocate(int numChannels, int) override
+    {
+        numGroups = (numChannels + channelsPerGroup - 1) / channelsPerGroup;
+        upState.assign((size_t) (numGroups * 2 * numSections), Vector::expand(0.0f));
+        downState.assign((size_t) (numGroups * 2 * numSections), Vector::expand(0.0f));
+    }
+
+    /** Runs the allpass chains; state holds the previous input and output of every section. */
+    Vector processSections(Vector sample, Vector* state) const noexcept
+    {
+        for (int section = 0; section < numSections; ++section)
+        {
+            auto& previousInput = state[2 * section];
+            auto& previousOutput = state[2 * section + 1];
+
+            const auto output = (sample - previousOutput) * coefficients[(size_t) section] + previousInput;
+            previousInput = sample;
+            previousOutput = output;
+            sample = output;
+        }
+
+        return sample;
+    }
+
+    static constexpr int channelsPerGroup = vectorWidth / 2;
+
+    int numSections = 0;
+    int numGroups = 0;
+    double branchDelays[2] {};
+    std::vector<Vector> coefficients;
+    std::vector<Vector> upState, downState;
+};
+
+//==============================================================================
+Oversampler::Oversampler() = default;
+Oversampler::~Oversampler() = default;
+
+void Oversampler::prepare(const juce::dsp::ProcessSpec& spec, FilterType type)
+{
+    filterType = type;
+    numChannels = (int) spec.numChannels;
+    maxBlockSize = (int) spec.maximumBlockSize;
+
+    stages.clear();
+
+    // The first stage decides the passband; later ones only have to reject
+    // images far above it and get away with much wider transition bands.
+    for (int stage = 0; stage < maxFactorLog2; ++stage)
+    {
+        if (filterType == FilterType::firHalfBand)
+            stages.push_back(std::make_unique<FirStage>(stage == 0 ? 48 : 16, 90.0));
+        else
+            stages.push_back(std::make_unique<IirStage>(90.0, stage == 0 ? 0.06 : 0.2));
+
+        stages.back()->prepare(numChannels, maxBlockSize << stage);
+    }
+
+    reset();
+}
+
+void Oversampler::reset() noexcept
+{
+    for (auto& stage : stages)
+        stage->reset();
+}
+
+void Oversampler::setFactorLog2(int newFactorLog2) noexcept
+{
+    newFactorLog2 = juce::jlimit(0, maxFactorLog2, newFactorLog2);
+
+    for (int stage = factorLog2; stage < newFactorLog2 && stage < (int) stages.size(); ++stage)
+        stages[(size_t) stage]->reset();
+
+    factorLog2 = newFactorLog2;
+}
+
+float Oversampler::getLatencyInSamples(int forFactorLog2) const noexcept
+{
+    float latency = 0.0f;
+
+    for (int stage = 0; stage < forFactorLog2 && stage < (int) stages.size(); ++stage)
+        latency += stages[(size_t) stage]->getLatency() / (float) (1 << stage);
+
+    return latency;
+}
+
+juce::dsp::AudioBlock<float> Oversampler::processSamplesUp(const juce::dsp::AudioBlock<const float>& input) noexcept
+{
+    jassert(factorLog2 > 0 && factorLog2 <= (int) stages.size());
+    jassert((int) input.getNumChannels() == numChannels);
+    jassert((int) input.getNumSamples() <= maxBlockSize);
+
+    // Asserting alone would let release builds write past the stage buffers.
+    if (factorLog2 <= 0 || factorLog2 > (int) stages.size()
+        || (int) input.getNumChannels() != numChannels
+        || (int) input.getNumSamples() > maxBlockSize)
+    {
+        numUpsampledSamples = 0;
+        return {};
+    }
+
+    auto stageInput = input;
+
+    for (int stage = 0; stage < factorLog2; ++stage)
+    {
+        auto& upsampled = stages[(size_t) stage]->upsampled;
+        stages[(size_t) stage]->processUp(stageInput);
+        stageInput = juce::dsp::AudioBlock<const float>(upsampled).getSubBlock(0, stageInput.getNumSamples() * 2);
+    }
+
+    numUpsampledSamples = (int) input.getNumSamples() << factorLog2;
+    return juce::dsp::AudioBlock<float>(stages[(size_t) factorLog2 - 1]->upsampled).getSubBlock(0, (size_t) numUpsampledSamples);
+}
+
+void Oversampler::processSamplesDown(juce::dsp::AudioBlock<float>& output) noexcept
+{
+    // Nothing to write back after processSamplesUp() refused its input.
+    if (numUpsampledSamples == 0)
+        return;
+
+    jassert((int) output.getNumSamples() << factorLog2 == numUpsampledSamples);
+    jassert((int) output.getNumChannels() == numChannels);
+
+    // Each stage downsamples into the buffer of the stage before it, the first into output.
+    for (int stage = factorLog2 - 1; stage > 0; --stage)
+    {
+        auto destination = juce::dsp::AudioBlock<float>(stages[(size_t) stage - 1]->upsampled)
+                               .getSubBlock(0, output.getNumSamples() << stage);
+        stages[(size_t) stage]->processDown(destination);
+    }
+
+    stages[0]->processDown(output);
+}
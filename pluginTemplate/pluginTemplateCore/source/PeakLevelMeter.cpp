@@ -1,58 +1,144 @@
 #include "pluginTemplateCore/PeakLevelMeter.h"
+#include "pluginTemplateCore/FixedSizeKernels.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Held peaks that have decayed below this (-120 dB) are cleared, so a
+    // wrapped sample clock can never resurrect a stale peak.
+    constexpr float silenceFloorGain = 1.0e-6f;
+}
+
+juce::uint64 PeakLevelMeter::HeldPeak::pack(HeldPeak peak) noexcept
+{
+    juce::uint32 gainBits;
+    std::memcpy(&gainBits, &peak.gain, sizeof(gainBits));
+    return ((juce::uint64) gainBits << 32) | peak.timestamp;
+}
+
+PeakLevelMeter::HeldPeak PeakLevelMeter::HeldPeak::unpack(juce::uint64 packed) noexcept
+{
+    HeldPeak peak;
+    const auto gainBits = (juce::uint32) (packed >> 32);
+    std::memcpy(&peak.gain, &gainBits, sizeof(gainBits));
+    peak.timestamp = (juce::uint32) packed;
+    return peak;
+}
 
 PeakLevelMeter::PeakLevelMeter() = default;
 
 void PeakLevelMeter::prepare(const juce::dsp::ProcessSpec& spec, float releaseTimeMs)
 {
     numChannels = (int)spec.numChannels;
-    peakGains.resize(numChannels);
+    heldPeaks.resize(numChannels);
 
-    for (auto& p : peakGains)
-        p.set(0.0f);
+    reset();
 
      // According to the IEC TR 60268-18:1995 standard for PPMs, the release time
      // is defined as the time it takes for the meter to drop by 20 dB.
      // A 20 dB drop corresponds to a linear amplitude ratio of 10^(-20/20) = 0.1.
-     constexpr float targetRatio = 0.1f; // Target for a 20dB drop.
+     constexpr double targetRatio = 0.1; // Target for a 20dB drop.
      const auto timeInSamples = spec.sampleRate * (releaseTimeMs / 1000.0f);
-     releaseCoeff = static_cast<float>(std::pow(targetRatio, 1.0 / timeInSamples));
+     releaseLogCoeff = static_cast<float>(std::log(targetRatio) / timeInSamples);
+}
+
+float PeakLevelMeter::getReleasedGain(HeldPeak peak, juce::uint32 now) const noexcept
+{
+    // Unsigned subtraction keeps the elapsed time correct across clock wrap-around. Read
+    // as signed, a peak stamped after now, i.e. one a reader on another thread loaded
+    // after the clock it compares against, counts as just reached instead of ~2^32
+    // samples old. Peaks cannot get 2^31 samples old: the floor drops them long before.
+    const auto elapsedSamples = (float) juce::jmax((juce::int32) 0, (juce::int32) (juce::uint32) (now - peak.timestamp));
+    return peak.gain * std::exp(releaseLogCoeff * elapsedSamples);
 }
 
 void PeakLevelMeter::process(const juce::AudioBuffer<float>& buffer)
 {
-    const int numBufferChannels = buffer.getNumChannels();
-    const int numBufferSamples = buffer.getNumSamples();
+    processSamples(juce::dsp::AudioBlock<const float>(buffer));
+}
+
+void PeakLevelMeter::process(const juce::AudioBuffer<double>& buffer)
+{
+    processSamples(juce::dsp::AudioBlock<const double>(buffer));
+}
+
+void PeakLevelMeter::process(const juce::dsp::AudioBlock<const float>& block)
+{
+    processSamples(block);
+}
+
+void PeakLevelMeter::process(const juce::dsp::AudioBlock<const double>& block)
+{
+    processSamples(block);
+}
+
+template <typename SampleType>
+void PeakLevelMeter::processSamples(const juce::dsp::AudioBlock<const SampleType>& block)
+{
+    const int numBlockChannels = (int) block.getNumChannels();
+    const int numBlockSamples = (int) block.getNumSamples();
+
+    jassert(numBlockChannels == numChannels);
 
-    jassert(numBufferChannels == numChannels);
+    const auto blockEnd = (juce::uint32) (sampleClock.get() + (juce::uint32) numBlockSamples);
 
     for (int ch = 0; ch < numChannels; ++ch)
     {
-        const float* channelData = buffer.getReadPointer(ch);
-
-        float runningPeak = peakGains[ch].get();
-        for (int i = 0; i < numBufferSamples; ++i)
-        {
-            const float sampleMagnitude = std::abs(channelData[i]);
-            if (sampleMagnitude > runningPeak)
-                // Attack: The new peak is updated instantly.
-                runningPeak = sampleMagnitude;
-            else
-                // Release: The stored peak decays sample-by-sample.
-                runningPeak *= releaseCoeff;
-        }
-        peakGains[ch].set(runningPeak);
+        // Abs-max of the whole block: unrolled over full sub-blocks, scalar over the tail.
+        const auto* samples = block.getChannelPointer((size_t) ch);
+        SampleType magnitude = 0;
+        int i = 0;
+
+        for (; i + magnitudeSubBlockSize <= numBlockSamples; i += magnitudeSubBlockSize)
+            magnitude = juce::jmax(magnitude, FixedSizeKernels::findMagnitude<magnitudeSubBlockSize>(samples + i));
+
+        for (; i < numBlockSamples; ++i)
+            magnitude = juce::jmax(magnitude, std::abs(samples[i]));
+
+        holdPeak(ch, (float) magnitude, blockEnd);
     }
+
+    sampleClock.set(blockEnd);
+}
+
+void PeakLevelMeter::processSilence(int numSamples) noexcept
+{
+    const auto blockEnd = (juce::uint32) (sampleClock.get() + (juce::uint32) numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        holdPeak(ch, 0.0f, blockEnd);
+
+    sampleClock.set(blockEnd);
+}
+
+void PeakLevelMeter::holdPeak(int channel, float blockPeak, juce::uint32 blockEnd) noexcept
+{
+    const auto held = HeldPeak::unpack(heldPeaks[channel].packed.get());
+    const float releasedPeak = getReleasedGain(held, blockEnd);
+
+    if (blockPeak > releasedPeak)
+        // Attack: the new peak replaces the held one instantly.
+        heldPeaks[channel].packed.set(HeldPeak::pack({blockPeak, blockEnd}));
+    else if (held.gain > 0.0f && releasedPeak < silenceFloorGain)
+        // Release has reached the floor: drop the held peak altogether.
+        heldPeaks[channel].packed.set(HeldPeak::pack({0.0f, blockEnd}));
+}
+
+float PeakLevelMeter::getCurrentGain(int channel) const noexcept
+{
+    // The clock first: processSamples() stores the peaks before the clock, so the peak
+    // read after it is at least as new, and getReleasedGain() clamps one that is newer.
+    const auto now = sampleClock.get();
+    return getReleasedGain(HeldPeak::unpack(heldPeaks[channel].packed.get()), now);
 }
 
 float PeakLevelMeter::getLevelDb(int channel) const
 {
     if (juce::isPositiveAndBelow(channel, numChannels))
-    {
-        const auto currentPeak = peakGains[channel].get();
-        return juce::Decibels::gainToDecibels(currentPeak);
-    }
+        return juce::Decibels::gainToDecibels(getCurrentGain(channel));
 
     return -100.0f;
 }
@@ -64,13 +150,23 @@ float PeakLevelMeter::getMonoPeakDb() const
 
     float maxPeak = 0.0f;
     for (int i = 0; i < numChannels; ++i)
-        maxPeak = std::max(maxPeak, peakGains[i].get());
+        maxPeak = std::max(maxPeak, getCurrentGain(i));
 
     return juce::Decibels::gainToDecibels(maxPeak);
 }
 
+void PeakLevelMeter::copyLevels(float* destination, int maxChannels) const noexcept
+{
+    const auto now = sampleClock.get();
+
+    for (int ch = 0; ch < juce::jmin(numChannels, maxChannels); ++ch)
+        destination[ch] = getReleasedGain(HeldPeak::unpack(heldPeaks[ch].packed.get()), now);
+}
+
 void PeakLevelMeter::reset()
 {
-    for (auto& p : peakGains)
-        p.set(-120.0f);
+    for (auto& p : heldPeaks)
+        p.packed.set(HeldPeak::pack({}));
+
+    sampleClock.set(0);
 }
@@ -0,0 +1,200 @@
+#include "pluginTemplateCore/ProcessProfiler.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr int worstBlockSampleBits = 24;
+    constexpr juce::uint64 worstBlockSampleMask = (1u << worstBlockSampleBits) - 1;
+
+    int getTimeBucket(juce::uint64 ns) noexcept
+    {
+        int bucket = 0;
+
+        while (ns > 1 && bucket < ProcessProfiler::numTimeBuckets - 1)
+        {
+            ns >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    /** The index of the bucket below which the given fraction of all counts lies, or -1 if there are no counts. */
+    template <size_t numBuckets>
+    int findPercentileBucket(const std::array<juce::uint64, numBuckets>& histogram, double fraction) noexcept
+    {
+        juce::uint64 total = 0;
+        for (const auto count : histogram)
+            total += count;
+
+        if (total == 0)
+            return -1;
+
+        const auto target = juce::jmax((juce::uint64) 1, (juce::uint64) std::ceil(fraction * (double) total));
+        juce::uint64 cumulative = 0;
+
+        for (size_t i = 0; i < numBuckets; ++i)
+        {
+            cumulative += histogram[i];
+
+            if (cumulative >= target)
+                return (int) i;
+        }
+
+        return (int) numBuckets - 1;
+    }
+}
+
+const char* ProcessProfiler::getStageName(Stage stage) noexcept
+{
+    switch (stage)
+    {
+        case Stage::inputMeter:  return "inputMeter";
+        case Stage::dsp:         return "dsp";
+        case Stage::limiter:     return "limiter";
+        case Stage::outputMeter: return "outputMeter";
+        case Stage::loudness:    return "loudness";
+        case Stage::block:       return "block";
+        case Stage::numStages:   break;
+    }
+
+    return "";
+}
+
+void ProcessProfiler::prepare(double sampleRate) noexcept
+{
+    nsPerSample.store(sampleRate > 0.0 ? 1.0e9 / sampleRate : 0.0, std::memory_order_relaxed);
+    clear();
+}
+
+juce::uint64 ProcessProfiler::recordStage(Stage stage, Clock::duration duration) noexcept
+{
+    const auto ns = (juce::uint64) juce::jmax((Clock::rep) 0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    auto& counters = stageCounters[(size_t) stage];
+
+    add(counters.count, 1);
+    add(counters.totalNs, ns);
+    add(counters.histogram[(size_t) getTimeBucket(ns)], 1);
+
+    if (ns > counters.maxNs.load(std::memory_order_relaxed))
+        counters.maxNs.store(ns, std::memory_order_relaxed);
+
+    return ns;
+}
+
+void ProcessProfiler::beginBlock() noexcept
+{
+    if (resetRequested.load(std::memory_order_relaxed))
+    {
+        resetRequested.store(false, std::memory_order_relaxed);
+        clear();
+    }
+}
+
+void ProcessProfiler::recordBlock(int numSamples, Clock::duration duration) noexcept
+{
+    const auto ns = recordStage(Stage::block, duration);
+    const auto deadlineNs = (double) numSamples * nsPerSample.load(std::memory_order_relaxed);
+
+    if (deadlineNs <= 0.0)
+        return;
+
+    const auto load = (double) ns / deadlineNs;
+    const auto loadBucket = juce::jmin(numLoadBuckets - 1, (int) (load / loadBucketWidth));
+
+    add(loadHistogram[(size_t) loadBucket], 1);
+    totalLoad.store(totalLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+
+    if (load > 1.0)
+        add(numOverruns, 1);
+
+    // Worst is judged by load rather than absolute time, so a long block is not worse than a short one that overran.
+    const auto previous = worstBlock.load(std::memory_order_relaxed);
+    const auto previousNs = previous >> worstBlockSampleBits;
+    const auto previousNumSamples = (double) (previous & worstBlockSampleMask);
+
+    if (previous == 0 || (double) ns * previousNumSamples > (double) previousNs * numSamples)
+    {
+        const auto packedSamples = (juce::uint64) juce::jmin((juce::uint64) numSamples, worstBlockSampleMask);
+        worstBlock.store((juce::jmin(ns, (juce::uint64) 0xffffffffff) << worstBlockSampleBits) | packedSamples,
+                         std::memory_order_relaxed);
+    }
+}
+
+void ProcessProfiler::clear() noexcept
+{
+    for (auto& counters : stageCounters)
+    {
+        counters.count.store(0, std::memory_order_relaxed);
+        counters.totalNs.store(0, std::memory_order_relaxed);
+        counters.maxNs.store(0, std::memory_order_relaxed);
+
+        for (auto& bucket : counters.histogram)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto& bucket : loadHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+
+    totalLoad.store(0.0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    worstBlock.store(0, std::memory_order_relaxed);
+}
+
+ProcessProfiler::Snapshot ProcessProfiler::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    const auto currentNsPerSample = nsPerSample.load(std::memory_order_relaxed);
+    snapshot.sampleRate = currentNsPerSample > 0.0 ? 1.0e9 / currentNsPerSample : 0.0;
+
+    for (size_t stage = 0; stage < stageCounters.size(); ++stage)
+    {
+        const auto& counters = stageCounters[stage];
+        auto& stageSnapshot = snapshot.stages[stage];
+
+        stageSnapshot.count = counters.count.load(std::memory_order_relaxed);
+        stageSnapshot.totalNs = counters.totalNs.load(std::memory_order_relaxed);
+        stageSnapshot.maxNs = counters.maxNs.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < counters.histogram.size(); ++i)
+            stageSnapshot.histogram[i] = counters.histogram[i].load(std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < loadHistogram.size(); ++i)
+        snapshot.loadHistogram[i] = loadHistogram[i].load(std::memory_order_relaxed);
+
+    snapshot.totalLoad = totalLoad.load(std::memory_order_relaxed);
+    snapshot.numOverruns = numOverruns.load(std::memory_order_relaxed);
+
+    const auto worst = worstBlock.load(std::memory_order_relaxed);
+    snapshot.worstBlockNs = worst >> worstBlockSampleBits;
+    snapshot.worstBlockNumSamples = (int) (worst & worstBlockSampleMask);
+
+    if (snapshot.worstBlockNumSamples > 0 && currentNsPerSample > 0.0)
+        snapshot.worstBlockLoad = (float) ((double) snapshot.worstBlockNs / (snapshot.worstBlockNumSamples * currentNsPerSample));
+
+    return snapshot;
+}
+
+double ProcessProfiler::StageSnapshot::getPercentileNs(double fraction) const noexcept
+{
+    const auto bucket = findPercentileBucket(histogram, fraction);
+    return bucket < 0 ? 0.0 : std::ldexp(1.0, bucket + 1);
+}
+
+double ProcessProfiler::Snapshot::getMeanLoad() const noexcept
+{
+    juce::uint64 numBlocks = 0;
+    for (const auto count : loadHistogram)
+        numBlocks += count;
+
+    return numBlocks > 0 ? totalLoad / (double) numBlocks : 0.0;
+}
+
+double ProcessProfiler::Snapshot::getLoadPercentile(double fraction) const noexcept
+{
+    const auto bucket = findPercentileBucket(loadHistogram, fraction);
+    return bucket < 0 ? 0.0 : (bucket + 1) * (double) loadBucketWidth;
+}
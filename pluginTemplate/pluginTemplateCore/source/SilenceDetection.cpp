@@ -0,0 +1,46 @@
+#include "pluginTemplateCore/SilenceDetection.h"
+#include "pluginTemplateCore/FixedSizeKernels.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr int subBlockSize = 64;
+
+    template <typename SampleType>
+    bool isChannelSilent(const SampleType* samples, int numSamples) noexcept
+    {
+        const auto threshold = (SampleType) SilenceDetection::threshold;
+        int i = 0;
+
+        for (; i + subBlockSize <= numSamples; i += subBlockSize)
+            if (FixedSizeKernels::findMagnitude<subBlockSize>(samples + i) > threshold)
+                return false;
+
+        for (; i < numSamples; ++i)
+            if (std::abs(samples[i]) > threshold)
+                return false;
+
+        return true;
+    }
+
+    template <typename SampleType>
+    bool isBlockSilent(const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            if (! isChannelSilent(block.getChannelPointer(channel), (int) block.getNumSamples()))
+                return false;
+
+        return true;
+    }
+}
+
+bool SilenceDetection::isSilent(const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    return isBlockSilent(block);
+}
+
+bool SilenceDetection::isSilent(const juce::dsp::AudioBlock<const double>& block) noexcept
+{
+    return isBlockSilent(block);
+}
@@ -0,0 +1,277 @@
+#include "pluginTemplateCore/SpectrumAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    // Shared by all instances in the process, so frame intervals can grow with their number.
+    std::atomic<int> numActiveAnalyzers {0};
+
+    constexpr double minFrameIntervalMs = 1000.0 / 60.0;
+    constexpr double maxFrameIntervalMs = 250.0;
+    constexpr double totalFramesPerSecond = 240.0; // Across all active analyzers.
+    constexpr int inactiveIntervalMs = 200;
+    constexpr float silenceDb = -120.0f;
+
+    void writeUInt16(std::byte* destination, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(destination, &value, sizeof(value));
+    }
+
+    void writeUInt32(std::byte* destination, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(destination, &value, sizeof(value));
+    }
+
+    void writeFloat(std::byte* destination, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUInt32(destination, bits);
+    }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer() = default;
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    setActive(false);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate, float newReleaseTimeMs)
+{
+    const juce::ScopedLock lock {workerLock};
+
+    decimationFactor = juce::jmax(1, (int) std::ceil(sampleRate / maxAnalysisRate - 1.0e-9));
+    analysisRate = sampleRate / decimationFactor;
+    decimationCount = 0;
+    decimationSum = 0.0f;
+    releaseTimeMs = newReleaseTimeMs;
+
+    // Periodic Hann window.
+    window.resize((size_t) fftSize);
+    for (int i = 0; i < fftSize; ++i)
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) fftSize);
+
+    float windowSum = 0.0f;
+    for (const auto w : window)
+        windowSum += w;
+
+    windowGain = 2.0f / windowSum;
+
+    fftData.assign(2 * (size_t) fftSize, 0.0f);
+    history.assign((size_t) fftSize, 0.0f);
+    historyWritePosition = 0;
+    numNewSamples = 0;
+
+    const auto binWidth = (float) analysisRate / (float) fftSize;
+    const auto maxBin = fftSize / 2;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto lowEdge = minFrequency * std::pow(maxFrequency / minFrequency, (float) band / numBands);
+        const auto highEdge = minFrequency * std::pow(maxFrequency / minFrequency, (float) (band + 1) / numBands);
+        auto& bins = bandBins[(size_t) band];
+
+        bins.firstBin = (int) std::ceil(lowEdge / binWidth);
+        bins.lastBin = juce::jmin(maxBin, (int) std::ceil(highEdge / binWidth) - 1);
+        bins.interpolation = -1.0f;
+
+        if (bins.firstBin > maxBin)
+        {
+            // Above Nyquist at this rate.
+            bins.firstBin = bins.lastBin = -1;
+        }
+        else if (bins.lastBin < bins.firstBin)
+        {
+            // Narrower than a bin, which happens at the low end: read between the neighbouring bins.
+            const auto centreBin = std::sqrt(lowEdge * highEdge) / binWidth;
+            bins.firstBin = juce::jmin(maxBin - 1, (int) centreBin);
+            bins.lastBin = bins.firstBin;
+            bins.interpolation = centreBin - (float) bins.firstBin;
+        }
+    }
+
+    smoothedLevels.fill(0.0f);
+    captureFifo.clear();
+    publish();
+}
+
+void SpectrumAnalyzer::setActive(bool shouldBeActive) noexcept
+{
+    if (active.exchange(shouldBeActive) != shouldBeActive)
+        numActiveAnalyzers.fetch_add(shouldBeActive ? 1 : -1);
+}
+
+void SpectrumAnalyzer::pushSamples(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    captureSamples(juce::dsp::AudioBlock<const float>(buffer));
+}
+
+void SpectrumAnalyzer::pushSamples(const juce::AudioBuffer<double>& buffer) noexcept
+{
+    captureSamples(juce::dsp::AudioBlock<const double>(buffer));
+}
+
+void SpectrumAnalyzer::pushSamples(const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    captureSamples(block);
+}
+
+void SpectrumAnalyzer::pushSamples(const juce::dsp::AudioBlock<const double>& block) noexcept
+{
+    captureSamples(block);
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::captureSamples(const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+{
+    if (! isActive())
+        return;
+
+    const auto numChannels = (int) block.getNumChannels();
+    const auto numSamples = (int) block.getNumSamples();
+
+    if (numChannels == 0)
+        return;
+
+    const auto channelGain = SampleType(1) / (SampleType) numChannels;
+
+    for (int offset = 0; offset < numSamples; offset += captureChunkSize)
+    {
+        CaptureChunk chunk;
+        chunk.numSamples = juce::jmin(captureChunkSize, numSamples - offset);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(chunk.samples.data(), block.getChannelPointer(0) + offset, channelGain, chunk.numSamples);
+
+            for (int channel = 1; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::addWithMultiply(chunk.samples.data(), block.getChannelPointer((size_t) channel) + offset, channelGain, chunk.numSamples);
+        }
+        else
+        {
+            // There is no mixed precision FloatVectorOperations kernel, so double input is summed in double and narrowed once.
+            for (int i = 0; i < chunk.numSamples; ++i)
+            {
+                SampleType sum = 0;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    sum += block.getChannelPointer((size_t) channel)[offset + i];
+
+                chunk.samples[(size_t) i] = (float) (sum * channelGain);
+            }
+        }
+
+        // Drops the chunk if the worker fell behind, which only costs display accuracy.
+        captureFifo.push(chunk);
+    }
+}
+
+double SpectrumAnalyzer::getFrameIntervalMs() const noexcept
+{
+    const auto numActive = juce::jmax(1, numActiveAnalyzers.load(std::memory_order_relaxed));
+    return juce::jlimit(minFrameIntervalMs, maxFrameIntervalMs, numActive * 1000.0 / totalFramesPerSecond);
+}
+
+int SpectrumAnalyzer::useTimeSlice()
+{
+    if (! isActive())
+        return inactiveIntervalMs;
+
+    const juce::ScopedLock lock {workerLock};
+
+    captureFifo.popAll([this](const CaptureChunk& chunk) { consumeChunk(chunk); });
+
+    const auto nowMs = juce::Time::getMillisecondCounterHiRes();
+
+    // A stopped transport publishes nothing, so readers keep hitting their cache.
+    if (numNewSamples > 0 && analysisRate > 0.0)
+    {
+        analyse(nowMs - lastAnalysisMs);
+        publish();
+    }
+
+    lastAnalysisMs = nowMs;
+    return juce::roundToInt(getFrameIntervalMs());
+}
+
+void SpectrumAnalyzer::consumeChunk(const CaptureChunk& chunk) noexcept
+{
+    // Decimation by averaging: a crude low-pass, but aliasing above 20 kHz is of no concern for display.
+    for (int i = 0; i < chunk.numSamples; ++i)
+    {
+        decimationSum += chunk.samples[(size_t) i];
+
+        if (++decimationCount < decimationFactor)
+            continue;
+
+        history[(size_t) historyWritePosition] = decimationSum / (float) decimationFactor;
+        historyWritePosition = (historyWritePosition + 1) % fftSize;
+        numNewSamples = juce::jmin(fftSize, numNewSamples + 1);
+        decimationCount = 0;
+        decimationSum = 0.0f;
+    }
+}
+
+void SpectrumAnalyzer::analyse(double elapsedMs) noexcept
+{
+    // Unwrap the history, oldest sample first, and window it.
+    const auto numTailSamples = fftSize - historyWritePosition;
+    std::copy(history.begin() + historyWritePosition, history.end(), fftData.begin());
+    std::copy(history.begin(), history.begin() + historyWritePosition, fftData.begin() + numTailSamples);
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    juce::FloatVectorOperations::multiply(fftData.data(), window.data(), fftSize);
+
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const auto release = (float) std::exp(-juce::jlimit(0.0, 1000.0, elapsedMs) / releaseTimeMs);
+
+    for (size_t band = 0; band < bandBins.size(); ++band)
+    {
+        const auto& bins = bandBins[band];
+        float magnitude = 0.0f;
+
+        if (bins.firstBin < 0)
+            magnitude = 0.0f;
+        else if (bins.interpolation >= 0.0f)
+            magnitude = juce::jmap(bins.interpolation, fftData[(size_t) bins.firstBin], fftData[(size_t) bins.firstBin + 1]);
+        else
+            magnitude = juce::FloatVectorOperations::findMaximum(fftData.data() + bins.firstBin, bins.lastBin - bins.firstBin + 1);
+
+        smoothedLevels[band] = juce::jmax(magnitude * windowGain, smoothedLevels[band] * release);
+    }
+
+    numNewSamples = 0;
+}
+
+void SpectrumAnalyzer::publish() noexcept
+{
+    {
+        const juce::SpinLock::ScopedLockType lock {frameLock};
+
+        writeUInt32(frame.data(), magic);
+        writeUInt16(frame.data() + 4, version);
+        writeUInt16(frame.data() + 6, (juce::uint16) numBands);
+        writeUInt32(frame.data() + 8, (juce::uint32) (generation.load(std::memory_order_relaxed) + 1));
+        writeFloat(frame.data() + 12, (float) getFrameIntervalMs());
+        writeFloat(frame.data() + 16, minFrequency);
+        writeFloat(frame.data() + 20, maxFrequency);
+
+        for (size_t band = 0; band < (size_t) numBands; ++band)
+            writeFloat(frame.data() + headerSize + sizeof(float) * band,
+                       juce::Decibels::gainToDecibels(smoothedLevels[band], silenceDb));
+    }
+
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+void SpectrumAnalyzer::copyFrame(std::byte* destination) const noexcept
+{
+    const juce::SpinLock::ScopedLockType lock {frameLock};
+    std::memcpy(destination, frame.data(), frameSize);
+}
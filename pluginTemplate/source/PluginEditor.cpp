@@ -8,9 +8,7 @@
 JucePluginTemplateAudioProcessorEditor::JucePluginTemplateAudioProcessorEditor (JucePluginTemplateAudioProcessor& p)
     : AudioProcessorEditor (&p),
       _processorRef (p),
-      _gainRelay{GAIN.getParamID()},
-      _bypassRelay{BYPASS.getParamID()},
-      _webBrowserComponent(juce::WebBrowserComponent::Options{}
+      _webBrowserComponent(_parameterWebBindings.addTo(juce::WebBrowserComponent::Options{}
                               .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
                               .withWinWebView2Options(
                                   juce::WebBrowserComponent::Options::WinWebView2{}
@@ -22,47 +20,179 @@ JucePluginTemplateAudioProcessorEditor::JucePluginTemplateAudioProcessorEditor (
                               .withResourceProvider(
                                   [this](const auto& url)
                                   {
-                                      return getWebResource(url, _dynamicResourceProvider);
+                                      // A freshly loaded page has no meters yet and needs a frame whatever the levels.
+                                      if (isPageRequest(url))
+                                          _meterRefreshRequested.store(true, std::memory_order_relaxed);
+
+                                      return getWebResource(url, _dynamicResourceProvider, *_webAssetCache);
                                   },
                                   juce::URL {LOCAL_DEV_SERVER_ADDRESS}.getOrigin())
-                              .withOptionsFrom(_gainRelay)
-                              .withOptionsFrom(_bypassRelay)
-                             ),
-      _gainSliderAttachment{
-          *_processorRef.getValueTreeState().getParameter(GAIN.getParamID()),
-          _gainRelay,
-          nullptr},
-      _bypassAttachment{
-          *_processorRef.getValueTreeState().getParameter(BYPASS.getParamID()),
-          _bypassRelay,
-          nullptr}
+                             )),
+      _vBlankAttachment{this, [this] { onDisplayRefresh(); }}
 {
+    _parameterWebBindings.attach(_processorRef.getValueTreeState());
     registerDynamicEndpoints();
 
+    // Frames queued while no editor was open are stale.
+    _processorRef.getMeterTelemetry().clear();
+
+    _processorRef.getSpectrumAnalyzer().setActive(true);
+    _spectrumWorkerThread->addTimeSliceClient(&_processorRef.getSpectrumAnalyzer());
+
     addAndMakeVisible(_webBrowserComponent);
     setSize (600, 400);
 
     _webBrowserComponent.goToURL(_webBrowserComponent.getResourceProviderRoot());
     // webBrowserComponent.goToURL("https://www.google.com"); // toString(true) for proper URL encoding
-    
-    startTimer(60);
 }
 
 void JucePluginTemplateAudioProcessorEditor::registerDynamicEndpoints()
 {
+    // Meter frames are pushed as the payload of the "meterLevels" event; this
+    // endpoint serves the same binary frame to clients that prefer to poll.
+    _dynamicResourceProvider.registerHandler(
+        "meterLevels.bin",
+        [this]
+        {
+            const auto* data = _meterFrameEncoder.getData();
+            return DynamicResourceProvider::Resource{{data, data + _meterFrameEncoder.getSize()},
+                                                     "application/octet-stream"};
+        },
+        [this] { return _meterFrameSequence; });
+
+    // The latest output spectrum, see SpectrumAnalyzer for the frame layout. The
+    // generation only moves when the worker published a new frame, so polls in
+    // between are answered from the cache.
+    _dynamicResourceProvider.registerHandler(
+        "spectrum.bin",
+        [this]
+        {
+            _processorRef.getSpectrumAnalyzer().copyFrame(_spectrumFrame.data());
+            return DynamicResourceProvider::Resource{{_spectrumFrame.begin(), _spectrumFrame.end()},
+                                                     "application/octet-stream"};
+        },
+        [this] { return _processorRef.getSpectrumAnalyzer().getGeneration(); });
+
+    // Level and loudness history, see LevelHistoryEncoder for the layout. The Web UI
+    // asks for the points after the last one it holds, so it only ever receives
+    // points it does not have yet, at whichever level its zoom needs.
+    _dynamicResourceProvider.registerQueryHandler(
+        "levelHistory.bin",
+        [this](const juce::StringPairArray& query)
+        {
+            const auto level = query.getValue("level", "0").getIntValue();
+            const auto since = (juce::uint64) juce::jmax((juce::int64) 0, query.getValue("since", "0").getLargeIntValue());
+            return DynamicResourceProvider::Resource{_levelHistoryEncoder.encode(_processorRef.getLevelHistory(), level, since),
+                                                     "application/octet-stream"};
+        });
+
+    // Channel names for the per-channel meters, e.g. ["L", "R", "C", "LFE", ...].
+    // The Web UI requests them whenever the channel count in the meter frames changes.
+    _dynamicResourceProvider.registerHandler(
+        "channelLayout.json",
+        [this]
+        {
+            const auto getChannelNames = [this](bool isInput)
+            {
+                juce::Array<juce::var> names;
+                const auto channelSet = _processorRef.getChannelLayoutOfBus(isInput, 0);
+
+                for (int channel = 0; channel < channelSet.size(); ++channel)
+                    names.add(juce::AudioChannelSet::getAbbreviatedChannelTypeName(channelSet.getTypeOfChannel(channel)));
+
+                return names;
+            };
+
+            juce::DynamicObject::Ptr layout = new juce::DynamicObject();
+            layout->setProperty("input", getChannelNames(true));
+            layout->setProperty("output", getChannelNames(false));
+            return DynamicResourceProvider::createJsonResource(layout.get());
+        });
+
+    // processBlock timings for the diagnostics panel, which hides itself when
+    // "enabled" is false because the build has no instrumentation.
+    _dynamicResourceProvider.registerHandler(
+        "profiling.json",
+        [this]
+        {
+            juce::DynamicObject::Ptr profiling = new juce::DynamicObject();
+            profiling->setProperty("enabled", PROCESS_PROFILING != 0);
+
+           #if PROCESS_PROFILING
+            const auto snapshot = _processorRef.getProfiler().getSnapshot();
+            const auto toMicroseconds = [](double ns) { return ns / 1000.0; };
+
+            juce::Array<juce::var> stages;
+            for (int i = 0; i < ProcessProfiler::numStages; ++i)
+            {
+                const auto stage = (ProcessProfiler::Stage) i;
+                const auto& stageSnapshot = snapshot.getStage(stage);
+
+                juce::DynamicObject::Ptr stageObject = new juce::DynamicObject();
+                stageObject->setProperty("name", ProcessProfiler::getStageName(stage));
+                stageObject->setProperty("count", (juce::int64) stageSnapshot.count);
+                stageObject->setProperty("meanUs", toMicroseconds(stageSnapshot.getMeanNs()));
+                stageObject->setProperty("p50Us", toMicroseconds(stageSnapshot.getPercentileNs(0.5)));
+                stageObject->setProperty("p99Us", toMicroseconds(stageSnapshot.getPercentileNs(0.99)));
+                stageObject->setProperty("maxUs", toMicroseconds((double) stageSnapshot.maxNs));
+                stages.add(stageObject.get());
+            }
+
+            juce::Array<juce::var> loadHistogram;
+            for (const auto count : snapshot.loadHistogram)
+                loadHistogram.add((juce::int64) count);
+
+            juce::DynamicObject::Ptr load = new juce::DynamicObject();
+            load->setProperty("mean", snapshot.getMeanLoad());
+            load->setProperty("p99", snapshot.getLoadPercentile(0.99));
+            load->setProperty("overruns", (juce::int64) snapshot.numOverruns);
+            load->setProperty("bucketWidth", ProcessProfiler::loadBucketWidth);
+            load->setProperty("histogram", loadHistogram);
+
+            juce::DynamicObject::Ptr worstBlock = new juce::DynamicObject();
+            worstBlock->setProperty("us", toMicroseconds((double) snapshot.worstBlockNs));
+            worstBlock->setProperty("numSamples", snapshot.worstBlockNumSamples);
+            worstBlock->setProperty("load", snapshot.worstBlockLoad);
+
+            profiling->setProperty("sampleRate", snapshot.sampleRate);
+            profiling->setProperty("stages", stages);
+            profiling->setProperty("load", load.get());
+            profiling->setProperty("worstBlock", worstBlock.get());
+           #endif
+
+            return DynamicResourceProvider::createJsonResource(profiling.get());
+        });
+
+    // Requested by the diagnostics panel's reset button; the audio thread clears the statistics.
     _dynamicResourceProvider.registerHandler(
-        "meterLevels.json",
+        "profilingReset.json",
         [this]
         {
-            juce::DynamicObject::Ptr data{new juce::DynamicObject{}};
-            data->setProperty("input", _processorRef.getMonoInputPeakLevelDb());
-            data->setProperty("output", _processorRef.getMonoOutputPeakLevelDb());
-            return DynamicResourceProvider::createJsonResource(data.get());
+           #if PROCESS_PROFILING
+            _processorRef.getProfiler().requestReset();
+           #endif
+            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+            result->setProperty("enabled", PROCESS_PROFILING != 0);
+            return DynamicResourceProvider::createJsonResource(result.get());
+        });
+
+    // Requested by the loudness panel's reset button; the audio thread clears integrated loudness and range.
+    _dynamicResourceProvider.registerHandler(
+        "loudnessReset.json",
+        [this]
+        {
+            _processorRef.getLoudnessMeter().requestReset();
+            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+            result->setProperty("reset", true);
+            return DynamicResourceProvider::createJsonResource(result.get());
         });
 }
 
 JucePluginTemplateAudioProcessorEditor::~JucePluginTemplateAudioProcessorEditor()
 {
+    _processorRef.getSpectrumAnalyzer().setActive(false);
+    _spectrumWorkerThread->removeTimeSliceClient(&_processorRef.getSpectrumAnalyzer());
+
     // It's good practice to clear the resource provider if it holds onto resources
     // or if the WebBrowserComponent might outlive captures in the lambda, though
     // with a static function like getLocalResource, this is less critical here.
@@ -80,7 +210,85 @@ void JucePluginTemplateAudioProcessorEditor::resized()
     _webBrowserComponent.setBounds (getLocalBounds());
 }
 
-void JucePluginTemplateAudioProcessorEditor::timerCallback()
+void JucePluginTemplateAudioProcessorEditor::drainMeterTelemetry()
 {
-    _webBrowserComponent.emitEventIfBrowserIsVisible("meterLevels", juce::var{});
+    constexpr auto outputOffset = (size_t) MeterFrame::maxChannels;
+
+    _processorRef.getMeterTelemetry().popAll([this](const MeterFrame& frame)
+    {
+        _meterLoudness = frame.loudness;
+
+        // Keep the loudest level of the batch, so every transient is shown at least once.
+        if (! _hasPendingMeterBatch || frame.numChannels != _numMeterChannels)
+        {
+            std::copy(frame.inputLevels.begin(), frame.inputLevels.end(), _meterLevels.begin());
+            std::copy(frame.outputLevels.begin(), frame.outputLevels.end(), _meterLevels.begin() + outputOffset);
+            _numMeterChannels = frame.numChannels;
+            _meterLimiterGain = frame.limiterGain;
+            _hasPendingMeterBatch = true;
+            return;
+        }
+
+        _meterLimiterGain = juce::jmin(_meterLimiterGain, frame.limiterGain);
+
+        for (size_t ch = 0; ch < (size_t) frame.numChannels; ++ch)
+        {
+            _meterLevels[ch] = juce::jmax(_meterLevels[ch], frame.inputLevels[ch]);
+            _meterLevels[outputOffset + ch] = juce::jmax(_meterLevels[outputOffset + ch], frame.outputLevels[ch]);
+        }
+    });
+}
+
+void JucePluginTemplateAudioProcessorEditor::onDisplayRefresh()
+{
+    if (! isShowing())
+    {
+        _wasShowing = false;
+        return;
+    }
+
+    drainMeterTelemetry();
+
+    // Levels that held still while the page reloaded or the editor was hidden would
+    // otherwise count as unchanged, so the page would get no frame and build no meters.
+    // The last levels are sent again in case no new frame arrives, e.g. while stopped.
+    if (_meterRefreshRequested.exchange(false, std::memory_order_relaxed) || ! _wasShowing)
+    {
+        _meterUpdateScheduler.invalidate();
+        _hasPendingMeterBatch = _hasPendingMeterBatch || _numMeterChannels > 0;
+    }
+
+    _wasShowing = true;
+
+    if (! _hasPendingMeterBatch)
+        return;
+
+    // Inputs and outputs are checked separately but in one call, so the scheduler sees every level.
+    // Momentary and short-term loudness are appended as gains, so a changing loudness
+    // reading is sent even while the peaks hold still. Integrated loudness and range
+    // follow them and ride along with every update, as does the limiter gain: it
+    // only moves while the output peaks do.
+    std::array<float, 2 * MeterFrame::maxChannels + 2> levels {};
+    const auto numChannels = (size_t) _numMeterChannels;
+    std::copy_n(_meterLevels.begin(), numChannels, levels.begin());
+    std::copy_n(_meterLevels.begin() + MeterFrame::maxChannels, numChannels, levels.begin() + numChannels);
+    levels[2 * numChannels] = juce::Decibels::decibelsToGain(_meterLoudness.momentaryLufs, LoudnessMeter::silenceLufs);
+    levels[2 * numChannels + 1] = juce::Decibels::decibelsToGain(_meterLoudness.shortTermLufs, LoudnessMeter::silenceLufs);
+
+    const auto decision = _meterUpdateScheduler.decide(juce::Time::getMillisecondCounterHiRes(),
+                                                       levels.data(), 2 * _numMeterChannels + 2);
+
+    // Too soon: keep accumulating, so a transient in between is not lost.
+    // Unchanged: start a new batch, so falling levels are picked up on the next refresh.
+    if (decision != MeterUpdateScheduler::Decision::update)
+    {
+        _hasPendingMeterBatch = decision == MeterUpdateScheduler::Decision::tooSoon;
+        return;
+    }
+
+    _meterFrameEncoder.encode(_meterFrameSequence++, _numMeterChannels,
+                              _meterLevels.data(), _meterLevels.data() + MeterFrame::maxChannels,
+                              _meterLoudness, _meterLimiterGain);
+    _webBrowserComponent.emitEventIfBrowserIsVisible("meterLevels", _meterFrameEncoder.toBase64());
+    _hasPendingMeterBatch = false;
 }
@@ -3,6 +3,38 @@
 #include "ParameterIDs.h"
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <pluginTemplateCore/ProcessingChain.h>
+#include <pluginTemplateCore/SilenceDetection.h>
+#include <pluginTemplateCore/SubBlockScheduler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace
+{
+    // The gain stage runs on sub-blocks of this many samples, at the oversampled rate.
+    // Small enough that a 32 sample live buffer is a single sub-block without a tail.
+    constexpr int gainSubBlockSize = 32;
+
+    // The limiter counts as released once its gain is within 0.001 dB of unity.
+    constexpr float releasedLimiterGain = 0.99989f;
+
+    template <typename SourceType, typename DestinationType>
+    void convertSamples(const juce::dsp::AudioBlock<SourceType>& source, const juce::dsp::AudioBlock<DestinationType>& destination) noexcept
+    {
+        jassert(source.getNumChannels() == destination.getNumChannels() && source.getNumSamples() == destination.getNumSamples());
+
+        for (size_t channel = 0; channel < source.getNumChannels(); ++channel)
+        {
+            const auto* in = source.getChannelPointer(channel);
+            auto* out = destination.getChannelPointer(channel);
+
+            for (size_t i = 0; i < source.getNumSamples(); ++i)
+                out[i] = static_cast<DestinationType>(in[i]);
+        }
+    }
+}
 
 
 JucePluginTemplateAudioProcessor::JucePluginTemplateAudioProcessor()
@@ -14,12 +46,19 @@ JucePluginTemplateAudioProcessor::JucePluginTemplateAudioProcessor()
                         .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                       #endif
                    ),
-    _valueTreeState {*this, nullptr, "Parameters", createParameterLayout(_parameters)}
+    _valueTreeState {*this, nullptr, "Parameters", PluginParameters::createLayout()}
 {
+    // Decode the Web UI once per process ahead of the first editor opening.
+    _webAssetCache->warmUpAsync();
+
+    _valueTreeState.addParameterListener(Parameters::oversampling.id, this);
+    _valueTreeState.addParameterListener(Parameters::limiter.id, this);
 }
 
 JucePluginTemplateAudioProcessor::~JucePluginTemplateAudioProcessor()
 {
+    _valueTreeState.removeParameterListener(Parameters::limiter.id, this);
+    _valueTreeState.removeParameterListener(Parameters::oversampling.id, this);
 }
 
 
@@ -95,22 +134,72 @@ void JucePluginTemplateAudioProcessor::prepareToPlay (double sampleRate, int sam
             static_cast<juce::uint32>(samplesPerBlock),
             static_cast<juce::uint32>(getTotalNumInputChannels())
     };
+    _processSpec = spec;
+    // Low latency allpass half-band stages; their phase error stays far above the audible band.
+    _oversampler.prepare(spec, Oversampler::FilterType::iirHalfBandPolyphase);
+    _dspProcessorDouble.prepare(spec, Parameters::gain.smoothingMs);
+    setOversamplingFactor(_parameterHandles.get(Parameters::oversampling));
+    // Both precisions are prepared, so the latency never depends on which one the host picks.
+    _limiter.prepare(spec);
+    _limiterDouble.prepare(spec);
+    // Only the 64-bit path uses it, for the single precision oversampler.
+    _oversamplingScratch.setSize(isUsingDoublePrecision() ? (int) spec.numChannels : 0,
+                                 isUsingDoublePrecision() ? samplesPerBlock : 0);
+    _limiterActive = _parameterHandles.get(Parameters::limiter);
+    _parameterSmoothers.prepare(sampleRate, _parameterHandles);
+    setLatencySamples(getSelectedLatencySamples());
+
+    // Long enough for the latency of any oversampling factor plus the limiter's lookahead.
+    int maxLatencySamples = 0;
+    for (int factorLog2 = 0; factorLog2 <= Oversampler::maxFactorLog2; ++factorLog2)
+        maxLatencySamples = juce::jmax(maxLatencySamples, juce::roundToInt(_oversampler.getLatencyInSamples(factorLog2)));
+    maxLatencySamples += _limiter.getLatencyInSamples();
+
+    getDryDelay<float>().prepare(spec, isUsingDoublePrecision() ? 0 : maxLatencySamples);
+    getDryDelay<double>().prepare(spec, isUsingDoublePrecision() ? maxLatencySamples : 0);
+    _warmUpBuffer.setSize(isUsingDoublePrecision() ? 0 : (int) spec.numChannels, isUsingDoublePrecision() ? 0 : maxLatencySamples);
+    _warmUpBufferDouble.setSize(isUsingDoublePrecision() ? (int) spec.numChannels : 0, isUsingDoublePrecision() ? maxLatencySamples : 0);
+    _bypassed = false;
     _inputLevelMeter.prepare(spec, 1700.0f);
     _outputLevelMeter.prepare(spec, 1700.0f);
+    _outputLoudnessMeter.prepare(spec, getChannelLayoutOfBus(false, 0));
+    _spectrumAnalyzer.prepare(sampleRate);
+    _levelHistory.prepare(sampleRate);
+    _meterSamplePosition = 0;
+    _silentInputSamples = 0;
+    _sleeping = false;
+    _skippedBlocks.store(0, std::memory_order_relaxed);
+
+   #if PROCESS_PROFILING
+    _profiler.prepare(sampleRate);
+   #endif
 }
 
 void JucePluginTemplateAudioProcessor::releaseResources()
 {
 }
 
+bool JucePluginTemplateAudioProcessor::isSupportedChannelSet(const juce::AudioChannelSet& channelSet)
+{
+    // Every channel is metered and sent to the Web UI individually.
+    if (channelSet.isDisabled() || channelSet.size() > MeterFrame::maxChannels)
+        return false;
+
+    // Ambisonics up to third order, i.e. 16 channels.
+    if (const auto order = channelSet.getAmbisonicOrder(); order >= 0)
+        return order <= 3;
+
+    // Named speaker layouts up to 7.1.4, plus discrete layouts of up to 16 channels.
+    return channelSet.size() <= 12 || channelSet.isDiscreteLayout();
+}
+
 bool JucePluginTemplateAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
  #if JucePlugin_IsMidiEffect
     juce::ignoreUnused (layouts);
     return true;
  #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    if (! isSupportedChannelSet(layouts.getMainOutputChannelSet()))
         return false;
 
    #if ! JucePlugin_IsSynth
@@ -126,6 +215,19 @@ void JucePluginTemplateAudioProcessor::processBlock (juce::AudioBuffer<float>& b
                                                  juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
+
+void JucePluginTemplateAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+                                                 juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -133,25 +235,308 @@ void JucePluginTemplateAudioProcessor::processBlock (juce::AudioBuffer<float>& b
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    const bool isBypassed = *_valueTreeState.getRawParameterValue(BYPASS.getParamID());
+    const bool isBypassed = _parameterHandles.get(Parameters::bypass);
+
+    if (const int oversamplingFactor = _parameterHandles.get(Parameters::oversampling);
+        oversamplingFactor != _oversampler.getFactorLog2())
+        setOversamplingFactor(oversamplingFactor);
+
+    auto& limiter = getLimiter<SampleType>();
+
+    if (const bool limiterEnabled = _parameterHandles.get(Parameters::limiter); limiterEnabled != _limiterActive)
+    {
+        limiter.reset();
+        _limiterActive = limiterEnabled;
+    }
+
+    using Block = juce::dsp::AudioBlock<SampleType>;
+    const auto block = Block(buffer).getSubsetChannelBlock(0, (size_t) totalNumInputChannels);
+
+    // The dry signal is kept on every block, so bypass can start at any time and
+    // play it with the same latency the processed signal has.
+    auto& dryDelay = getDryDelay<SampleType>();
 
     if (isBypassed)
     {
+        dryDelay.process(block, getActiveLatencySamples());
+        _bypassed = true;
         _inputLevelMeter.reset();
         _outputLevelMeter.reset();
+        updateLimiterParameters(limiter, buffer.getNumSamples());
+        // Bypassed output is still delivered audio, so it keeps counting towards the integrated loudness.
+        _outputLoudnessMeter.process(buffer);
+        _spectrumAnalyzer.pushSamples(buffer);
+        pushMeterFrame(buffer.getNumSamples(), 1.0f);
         return;
     }
 
+    if (_bypassed)
+        resumeFromBypass<SampleType>();
+
+    dryDelay.push(block);
+
     if (buffer.getNumSamples() == 0)
         return;
 
-    
-    _inputLevelMeter.process(buffer);
+    PROCESS_PROFILER_BLOCK(_profiler, buffer.getNumSamples());
+
+    // Checked before anything runs, so a block in which signal returns is processed in full.
+    const bool inputIsSilent = SilenceDetection::isSilent(block);
+    _silentInputSamples = inputIsSilent ? _silentInputSamples + buffer.getNumSamples() : 0;
+
+    if (_sleeping && inputIsSilent)
+    {
+        processSleeping(block);
+        return;
+    }
+
+    _sleeping = false;
+    float limiterGain = 1.0f;
+
+    // All stages run on one cache-sized tile before the next one is loaded, so large
+    // offline blocks are read from memory once instead of once per stage. The profiler
+    // stages below therefore time tiles rather than whole blocks. Tiles never exceed the
+    // prepared block size, so a host sending more than it announced cannot overrun the
+    // oversampler's stage buffers or the 64-bit path's scratch buffer.
+    const auto tileLength = juce::jmin(getProcessingTileLength<SampleType>((size_t) totalNumInputChannels * (size_t) _oversampler.getFactor()),
+                                       (size_t) _processSpec.maximumBlockSize);
+
+    auto chain = makeProcessingChain(
+        tileLength,
+        [&](const Block& tile)
+        {
+            PROCESS_PROFILER_SCOPE(_profiler, ProcessProfiler::Stage::inputMeter);
+            _inputLevelMeter.process(tile);
+        },
+        [&](const Block& tile)
+        {
+            PROCESS_PROFILER_SCOPE(_profiler, ProcessProfiler::Stage::dsp);
+            processGain(tile);
+        },
+        [&](const Block& tile)
+        {
+            updateLimiterParameters(limiter, (int) tile.getNumSamples());
+
+            if (! _limiterActive)
+                return;
+
+            PROCESS_PROFILER_SCOPE(_profiler, ProcessProfiler::Stage::limiter);
+            limiter.process(tile);
+            limiterGain = juce::jmin(limiterGain, limiter.getLastBlockMinimumGain());
+        },
+        [&](const Block& tile)
+        {
+            PROCESS_PROFILER_SCOPE(_profiler, ProcessProfiler::Stage::outputMeter);
+            _outputLevelMeter.process(tile);
+        },
+        [&](const Block& tile)
+        {
+            PROCESS_PROFILER_SCOPE(_profiler, ProcessProfiler::Stage::loudness);
+            _outputLoudnessMeter.process(tile);
+        },
+        [&](const Block& tile)
+        {
+            // Only a downmix into a wait-free FIFO; the FFT runs on the editor's worker thread.
+            _spectrumAnalyzer.pushSamples(tile);
+        });
+
+    chain.process(block);
+
+    // Sleep once every stage's tail has played out: the delay lines only hold
+    // silence, the limiter has released and the output itself is silent.
+    if (inputIsSilent
+        && _silentInputSamples >= juce::roundToInt(_oversampler.getLatencyInSamples()) + limiter.getLatencyInSamples()
+        && limiterGain >= releasedLimiterGain
+        && SilenceDetection::isSilent(block))
+        _sleeping = true;
+
+    pushMeterFrame(buffer.getNumSamples(), limiterGain);
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::resumeFromBypass()
+{
+    _bypassed = false;
+    _oversampler.reset();
+    auto& limiter = getLimiter<SampleType>();
+    limiter.reset();
+
+    // The bypassed output ended latency samples behind the input. Running the stages over
+    // those samples leaves exactly them in the oversampling filters and the lookahead, so
+    // the processed output continues where the bypassed one stopped instead of starting
+    // with the latency's worth of silence.
+    const auto history = juce::dsp::AudioBlock<SampleType>(getWarmUpBuffer<SampleType>())
+                             .getSubBlock(0, (size_t) getActiveLatencySamples());
+    getDryDelay<SampleType>().copyLatest(history);
+
+    // In pieces of at most the prepared block size, like the tiles in processSamples().
+    const auto maxPieceLength = (size_t) juce::jmax(1, (int) _processSpec.maximumBlockSize);
+
+    for (size_t start = 0; start < history.getNumSamples(); start += maxPieceLength)
+    {
+        const auto piece = history.getSubBlock(start, juce::jmin(maxPieceLength, history.getNumSamples() - start));
+        processGain(piece);
+
+        if (_limiterActive)
+            limiter.process(piece);
+    }
+
+    // Whatever the stages held before bypass is gone, so sleeping has to wait for a new tail.
+    _silentInputSamples = 0;
+    _sleeping = false;
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::processSleeping(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    const auto numSamples = (int) block.getNumSamples();
+
+    // The input is at most -150 dB, so clearing it is the output every stage would have produced.
+    block.clear();
 
-    const float gainValue = *_valueTreeState.getRawParameterValue(GAIN.getParamID());
-    _dspProcessor.process(buffer, gainValue);
+    _inputLevelMeter.processSilence(numSamples);
+    _outputLevelMeter.processSilence(numSamples);
+    _outputLoudnessMeter.processSilence(numSamples);
+    updateLimiterParameters(getLimiter<SampleType>(), numSamples);
+    _spectrumAnalyzer.pushSamples(block);
+    _skippedBlocks.fetch_add(1, std::memory_order_relaxed);
 
-    _outputLevelMeter.process(buffer);
+    pushMeterFrame(numSamples, 1.0f);
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::processGain(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        auto inOut = block;
+        _oversampler.process(inOut, [&](const juce::dsp::AudioBlock<float>& oversampledBlock)
+        {
+            applyGain(_dspProcessor, oversampledBlock);
+        });
+    }
+    else if (_oversampler.getFactorLog2() == 0)
+    {
+        applyGain(_dspProcessorDouble, block);
+    }
+    else
+    {
+        // The oversampling filters are single precision, so only this path narrows the
+        // 64-bit signal, and only while oversampling is switched on.
+        auto narrowed = juce::dsp::AudioBlock<float>(_oversamplingScratch)
+                            .getSubsetChannelBlock(0, block.getNumChannels())
+                            .getSubBlock(0, block.getNumSamples());
+
+        convertSamples(block, narrowed);
+        processGain(narrowed);
+        convertSamples(narrowed, block);
+    }
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::applyGain(DspProcessor<SampleType>& processor, const juce::dsp::AudioBlock<SampleType>& block)
+{
+    using Block = juce::dsp::AudioBlock<SampleType>;
+
+    // Reading the gain per sub-block follows automation at the same rate for any host block size.
+    const auto readGain = [this] { return (SampleType) _parameterHandles.get(Parameters::gain); };
+
+    forEachSubBlock<gainSubBlockSize>(block,
+        [&](const Block& subBlock) { processor.template processFixed<gainSubBlockSize>(subBlock, readGain()); },
+        [&](const Block& tail) { processor.process(tail, readGain()); });
+}
+
+template <typename SampleType>
+LookaheadLimiter<SampleType>& JucePluginTemplateAudioProcessor::getLimiter() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return _limiter;
+    else
+        return _limiterDouble;
+}
+
+template <typename SampleType>
+DelayBuffer<SampleType>& JucePluginTemplateAudioProcessor::getDryDelay() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return _dryDelay;
+    else
+        return _dryDelayDouble;
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType>& JucePluginTemplateAudioProcessor::getWarmUpBuffer() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return _warmUpBuffer;
+    else
+        return _warmUpBufferDouble;
+}
+
+template <typename SampleType>
+void JucePluginTemplateAudioProcessor::updateLimiterParameters(LookaheadLimiter<SampleType>& limiter, int numSamples) noexcept
+{
+    // Advanced even while the limiter is off or bypassed, so it always resumes from the current settings.
+    const auto ceilingDb = _parameterSmoothers.getNextBlockValue(_parameterHandles, Parameters::ceiling, numSamples);
+    const auto releaseMs = _parameterSmoothers.getNextBlockValue(_parameterHandles, Parameters::release, numSamples);
+
+    if (_limiterActive)
+        limiter.setParameters(ceilingDb, releaseMs);
+}
+
+void JucePluginTemplateAudioProcessor::pushMeterFrame(int numSamples, float limiterGain)
+{
+    _meterSamplePosition += numSamples;
+
+    MeterFrame frame;
+    frame.sequence = _meterFrameSequence++;
+    frame.samplePosition = _meterSamplePosition;
+    frame.numChannels = juce::jmin(getTotalNumInputChannels(), MeterFrame::maxChannels);
+    _inputLevelMeter.copyLevels(frame.inputLevels.data(), frame.numChannels);
+    _outputLevelMeter.copyLevels(frame.outputLevels.data(), frame.numChannels);
+    frame.limiterGain = limiterGain;
+    frame.loudness = {_outputLoudnessMeter.getMomentaryLufs(), _outputLoudnessMeter.getShortTermLufs(),
+                      _outputLoudnessMeter.getIntegratedLufs(), _outputLoudnessMeter.getLoudnessRangeLu()};
+
+    _levelHistory.push(frame, numSamples);
+
+    // Never blocks: if no editor is draining the FIFO, the frame is dropped.
+    _meterTelemetry.push(frame);
+}
+
+void JucePluginTemplateAudioProcessor::setOversamplingFactor(int factorLog2)
+{
+    _oversampler.setFactorLog2(factorLog2);
+
+    // Neither allocates nor locks, so this is fine on the audio thread. It restarts the gain ramp,
+    // which only matters for the block the factor changes in.
+    auto oversampledSpec = _processSpec;
+    oversampledSpec.sampleRate *= _oversampler.getFactor();
+    oversampledSpec.maximumBlockSize *= (juce::uint32) _oversampler.getFactor();
+    _dspProcessor.prepare(oversampledSpec, Parameters::gain.smoothingMs);
+    _dspProcessorDouble.reset();
+}
+
+int JucePluginTemplateAudioProcessor::getActiveLatencySamples() const noexcept
+{
+    return juce::roundToInt(_oversampler.getLatencyInSamples()) + (_limiterActive ? _limiter.getLatencyInSamples() : 0);
+}
+
+int JucePluginTemplateAudioProcessor::getSelectedLatencySamples() const
+{
+    const auto oversamplingLatency = _oversampler.getLatencyInSamples(_parameterHandles.get(Parameters::oversampling));
+    const auto limiterLatency = _parameterHandles.get(Parameters::limiter) ? _limiter.getLatencyInSamples() : 0;
+    return juce::roundToInt(oversamplingLatency) + limiterLatency;
+}
+
+void JucePluginTemplateAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(newValue);
+
+    // Neither parameter is automatable, so this runs on the thread of the UI or
+    // state change, and processBlock picks up the change with its next block.
+    if (parameterID == Parameters::oversampling.id || parameterID == Parameters::limiter.id)
+        setLatencySamples(getSelectedLatencySamples());
 }
 
 //==============================================================================
@@ -186,15 +571,57 @@ float JucePluginTemplateAudioProcessor::getMonoOutputPeakLevelDb() const
 //==============================================================================
 void JucePluginTemplateAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // Use APVTS to get the state
-    auto state = _valueTreeState.copyState(); // Get the ValueTree state
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    if (xml != nullptr)
-        copyXmlToBinary (*xml, destData);
+    getStateInformation (destData, StateFormat::binary);
+}
+
+void JucePluginTemplateAudioProcessor::getStateInformation (juce::MemoryBlock& destData, StateFormat format)
+{
+    if (format == StateFormat::xml)
+    {
+        // Use APVTS to get the state
+        auto state = _valueTreeState.copyState(); // Get the ValueTree state
+        std::unique_ptr<juce::XmlElement> xml (state.createXml());
+        if (xml != nullptr)
+            copyXmlToBinary (*xml, destData);
+        return;
+    }
+
+    std::array<BinaryState::Entry, PluginParameters::numParameters> entries;
+    PluginParameters::forEach([&](const auto& spec)
+    {
+        entries[spec.index] = {PluginParameters::idHashes[spec.index], _parameterHandles.getRawValue(spec.index)};
+    });
+
+    // Anything stored in the state tree besides the parameters travels as the extra blob.
+    const auto& state = _valueTreeState.state;
+    const auto hasExtraState = state.getNumProperties() > 0
+                               || std::any_of(state.begin(), state.end(), [] (const auto& child) { return ! child.hasType ("PARAM"); });
+
+    if (! hasExtraState)
+    {
+        BinaryState::write (destData, entries.data(), entries.size());
+        return;
+    }
+
+    juce::ValueTree extraState (state.getType());
+    extraState.copyPropertiesFrom (state, nullptr);
+    for (const auto& child : state)
+        if (! child.hasType ("PARAM"))
+            extraState.appendChild (child.createCopy(), nullptr);
+
+    juce::MemoryOutputStream blob;
+    extraState.writeToStream (blob);
+    BinaryState::write (destData, entries.data(), entries.size(), blob.getData(), blob.getDataSize());
 }
 
 void JucePluginTemplateAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    if (BinaryState::Reader binaryState; binaryState.open (data, (size_t) juce::jmax (0, sizeInBytes)))
+    {
+        restoreBinaryState (binaryState);
+        return;
+    }
+
     // Use APVTS to restore the state
     std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
     if (xmlState != nullptr)
@@ -202,26 +629,48 @@ void JucePluginTemplateAudioProcessor::setStateInformation (const void* data, in
             _valueTreeState.replaceState (juce::ValueTree::fromXml (*xmlState));
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout
-JucePluginTemplateAudioProcessor::createParameterLayout(
-    JucePluginTemplateAudioProcessor::Parameters& parameters) {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-  {
-    auto parameter = std::make_unique<juce::AudioParameterFloat>(
-        GAIN, "gain", juce::NormalisableRange<float>{0.f, 1.f, 0.01f, 0.9f}, 1.f);
-    parameters.gain = parameter.get();
-    layout.add(std::move(parameter));
-  }
-
-  {
-    auto parameter = std::make_unique<juce::AudioParameterBool>(
-        BYPASS, "bypass", false,
-        juce::AudioParameterBoolAttributes{}.withLabel("Bypass"));
-    parameters.bypass = parameter.get();
-    layout.add(std::move(parameter));
-  }
-
-  return layout;
+void JucePluginTemplateAudioProcessor::restoreBinaryState(const BinaryState::Reader& state)
+{
+    // Parameters missing from the state fall back to their defaults, like replaceState() does.
+    std::array<float, PluginParameters::numParameters> normalisedValues;
+    for (size_t i = 0; i < normalisedValues.size(); ++i)
+        normalisedValues[i] = _parameterHandles.getParameter(i).getDefaultValue();
+
+    // Entries of parameters this version does not know are skipped.
+    for (size_t i = 0; i < state.getNumEntries(); ++i)
+    {
+        const auto entry = state.getEntry(i);
+        const auto index = PluginParameters::findIndexOfIDHash(entry.idHash);
+
+        if (index >= 0 && std::isfinite(entry.value))
+            normalisedValues[(size_t) index] = juce::jlimit(0.0f, 1.0f, _parameterHandles.getParameter((size_t) index).convertTo0to1(entry.value));
+    }
+
+    // Like replaceState(), unchanged values are left alone, so loading a session neither
+    // notifies the host nor reaches parameterChanged() for every parameter.
+    for (size_t i = 0; i < normalisedValues.size(); ++i)
+        if (auto& parameter = _parameterHandles.getParameter(i); parameter.getValue() != normalisedValues[i])
+            parameter.setValueNotifyingHost(normalisedValues[i]);
+
+    // Like replaceState(), the stored extra state replaces whatever the tree holds besides the parameters.
+    auto& tree = _valueTreeState.state;
+    tree.removeAllProperties(nullptr);
+
+    for (int i = tree.getNumChildren(); --i >= 0;)
+        if (! tree.getChild(i).hasType("PARAM"))
+            tree.removeChild(i, nullptr);
+
+    if (state.getBlobSize() == 0)
+        return;
+
+    const auto extraState = juce::ValueTree::readFromData(state.getBlobData(), state.getBlobSize());
+    if (! extraState.hasType(tree.getType()))
+        return;
+
+    tree.copyPropertiesFrom(extraState, nullptr);
+
+    for (const auto& child : extraState)
+        tree.appendChild(child.createCopy(), nullptr);
 }
 
 // This creates new instances of the plugin..
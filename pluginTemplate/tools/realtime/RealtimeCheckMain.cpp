@@ -0,0 +1,246 @@
+#include "RealtimeSanitizer.h"
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: pluginTemplateRealtimeCheck [options]\n"
+                     "  --blocks <count>         processBlock calls per configuration (default: 200)\n"
+                     "  --max-reports <count>    print stack traces for this many violations (default: 20)\n"
+                     "\n"
+                     "Runs the processor in single and double precision across sample rates,\n"
+                     "block sizes, channel layouts and parameter changes with allocation and lock\n"
+                     "detection on the processing thread. Exits with 1 if processBlock allocated,\n"
+                     "freed or locked a mutex, or if the bypassed output does not line up with\n"
+                     "the processed one.\n";
+    }
+
+    const double sampleRates[] = {22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 192000.0};
+    const int blockSizes[] = {1, 16, 64, 128, 441, 512, 1024, 4096};
+
+    juce::Array<juce::AudioChannelSet> getChannelSets()
+    {
+        return {juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create5point1()};
+    }
+
+    /**
+     * Changes parameters between blocks, as a UI or host would from another thread:
+     * bypass and limiter toggles, gain and limiter setting jumps and every oversampling factor.
+     */
+    void changeParameters(juce::AudioProcessor& processor, int blockIndex, juce::Random& random)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+            if (ranged == nullptr)
+                continue;
+
+            const auto id = ranged->getParameterID();
+
+            if (id == "BYPASS" && blockIndex % 37 == 0)
+                ranged->setValueNotifyingHost(ranged->getValue() < 0.5f ? 1.0f : 0.0f);
+            else if (id == "GAIN" && blockIndex % 5 == 0)
+                ranged->setValueNotifyingHost(random.nextFloat());
+            else if (id == "OVERSAMPLING" && blockIndex % 23 == 0)
+                ranged->setValueNotifyingHost(random.nextFloat());
+            else if (id == "LIMITER" && blockIndex % 29 == 0)
+                ranged->setValueNotifyingHost(ranged->getValue() < 0.5f ? 1.0f : 0.0f);
+            else if ((id == "CEILING" || id == "RELEASE") && blockIndex % 7 == 0)
+                ranged->setValueNotifyingHost(random.nextFloat());
+        }
+    }
+
+    void setParameter(juce::AudioProcessor& processor, const juce::String& id, float value)
+    {
+        for (auto* parameter : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter); ranged != nullptr && ranged->getParameterID() == id)
+                ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+    }
+
+    /**
+     * Bypass has to play the input with the latency the host compensates for, and
+     * switching either way must neither skip nor repeat samples. At unity gain with
+     * oversampling off and the limiter on but never reaching its ceiling, the output
+     * is then the input delayed by the reported latency, sample for sample, across
+     * bypass toggles. Returns false and prints the first sample that differs otherwise.
+     */
+    template <typename SampleType>
+    bool checkBypassAlignment(juce::AudioProcessor& processor, double sampleRate, int blockSize)
+    {
+        setParameter(processor, "BYPASS", 0.0f);
+        setParameter(processor, "GAIN", 1.0f);
+        setParameter(processor, "OVERSAMPLING", 0.0f);
+        setParameter(processor, "LIMITER", 1.0f);
+        setParameter(processor, "CEILING", 0.0f);
+
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto latency = processor.getLatencySamples();
+        const auto numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        const auto numSamples = juce::roundToInt(sampleRate * 0.2);
+
+        // Half scale, well below the 0 dB ceiling.
+        juce::AudioBuffer<SampleType> input (numChannels, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < numSamples; ++sample)
+                input.setSample(channel, sample, (SampleType) (0.5 * std::sin(juce::MathConstants<double>::twoPi * (440.0 + 110.0 * channel) * sample / sampleRate)));
+
+        juce::AudioBuffer<SampleType> output;
+        output.makeCopyOf(input);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            // Bypassed during the second and the fourth quarter.
+            setParameter(processor, "BYPASS", (start * 4 / numSamples) % 2 == 1 ? 1.0f : 0.0f);
+
+            juce::AudioBuffer<SampleType> block (output.getArrayOfWritePointers(), numChannels, start, juce::jmin(blockSize, numSamples - start));
+            processor.processBlock(block, midi);
+        }
+
+        processor.releaseResources();
+        setParameter(processor, "BYPASS", 0.0f);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const auto expected = sample >= latency ? input.getSample(channel, sample - latency) : SampleType(0);
+
+                // Only the limiter's unity gain, computed as an average, may round.
+                if (std::abs(output.getSample(channel, sample) - expected) > SampleType(1.0e-6))
+                {
+                    std::cout << "bypass misaligned at sample " << sample << " of channel " << channel
+                              << " with a latency of " << latency << " samples" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /** Returns the number of violations in this configuration, processed in SampleType precision. */
+    template <typename SampleType>
+    juce::uint64 runConfiguration(juce::AudioProcessor& processor, double sampleRate, int blockSize, int numBlocks,
+                                  juce::Random& random)
+    {
+        // Hosts pick the precision before preparing, as prepareToPlay() sizes its buffers for it.
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<SampleType> buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        const auto violationsBefore = RealtimeSanitizer::getNumViolations();
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            changeParameters(processor, blockIndex, random);
+
+            // Hosts may pass any block size up to the prepared one.
+            const auto numSamples = blockIndex % 3 == 1 ? random.nextInt({1, blockSize + 1}) : blockSize;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < numSamples; ++sample)
+                    buffer.setSample(channel, sample, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+
+            juce::AudioBuffer<SampleType> block (buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+            const RealtimeSanitizer::ScopedRealtimeContext realtimeContext;
+            processor.processBlock(block, midi);
+        }
+
+        processor.releaseResources();
+        return RealtimeSanitizer::getNumViolations() - violationsBefore;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments {argc, argv};
+
+    if (arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    RealtimeSanitizer::initialise();
+
+    if (const auto maxReports = arguments.getValueForOption("--max-reports"); maxReports.isNotEmpty())
+        RealtimeSanitizer::setMaxReportedViolations(maxReports.getIntValue());
+
+    const auto blocksOption = arguments.getValueForOption("--blocks");
+    const auto numBlocks = juce::jmax(1, blocksOption.isNotEmpty() ? blocksOption.getIntValue() : 200);
+
+    // Parameter attachments and timers inside the processor expect a message manager.
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::Random random {1234};
+    int numConfigurations = 0;
+    int numFailedConfigurations = 0;
+
+    for (const auto& channelSet : getChannelSets())
+    {
+        std::unique_ptr<juce::AudioProcessor> processor (createPluginFilter());
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+
+        if (! processor->setBusesLayout(layout))
+        {
+            std::cout << "skipped " << channelSet.getDescription() << ": layout not supported" << std::endl;
+            continue;
+        }
+
+        for (const auto sampleRate : sampleRates)
+        {
+            for (const auto blockSize : blockSizes)
+            {
+                for (const auto doublePrecision : {false, true})
+                {
+                    ++numConfigurations;
+
+                    const auto violations = doublePrecision
+                        ? runConfiguration<double>(*processor, sampleRate, blockSize, numBlocks, random)
+                        : runConfiguration<float>(*processor, sampleRate, blockSize, numBlocks, random);
+
+                    const auto aligned = doublePrecision
+                        ? checkBypassAlignment<double>(*processor, sampleRate, blockSize)
+                        : checkBypassAlignment<float>(*processor, sampleRate, blockSize);
+
+                    if (violations > 0 || ! aligned)
+                    {
+                        ++numFailedConfigurations;
+                        std::cout << "FAILED " << channelSet.getDescription() << ", " << sampleRate << " Hz, "
+                                  << blockSize << " samples, " << (doublePrecision ? "double" : "float")
+                                  << ": " << violations << " violations" << (aligned ? "" : ", bypass misaligned") << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << numConfigurations - numFailedConfigurations << " of " << numConfigurations
+              << " configurations real-time safe and aligned, " << RealtimeSanitizer::getNumViolations()
+              << " violations in total" << std::endl;
+
+    return numFailedConfigurations > 0 ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+#include "RealtimeSanitizer.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// The allocator entry points glibc exports under its own names, so the hooks
+// below can forward to it without going through dlsym, which allocates itself.
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    /** The next definition of a hooked libpthread function, resolved once, as dlsym allocates. */
+    template <typename Function>
+    struct NextFunction
+    {
+        const char* name;
+        std::atomic<Function> function {nullptr};
+
+        Function get() noexcept
+        {
+            if (auto resolved = function.load(std::memory_order_relaxed))
+                return resolved;
+
+            const auto resolved = reinterpret_cast<Function>(::dlsym(RTLD_NEXT, name));
+            function.store(resolved, std::memory_order_relaxed);
+            return resolved;
+        }
+    };
+
+    using MutexFunction = int (*)(pthread_mutex_t*);
+    using RwlockFunction = int (*)(pthread_rwlock_t*);
+    using TimedRwlockFunction = int (*)(pthread_rwlock_t*, const timespec*);
+    using ClockRwlockFunction = int (*)(pthread_rwlock_t*, clockid_t, const timespec*);
+
+    NextFunction<MutexFunction> nextMutexLock {"pthread_mutex_lock"};
+    NextFunction<MutexFunction> nextMutexTrylock {"pthread_mutex_trylock"};
+    NextFunction<int (*)(pthread_mutex_t*, clockid_t, const timespec*)> nextMutexClocklock {"pthread_mutex_clocklock"};
+    NextFunction<RwlockFunction> nextRwlockRdlock {"pthread_rwlock_rdlock"};
+    NextFunction<RwlockFunction> nextRwlockWrlock {"pthread_rwlock_wrlock"};
+    NextFunction<RwlockFunction> nextRwlockTryrdlock {"pthread_rwlock_tryrdlock"};
+    NextFunction<RwlockFunction> nextRwlockTrywrlock {"pthread_rwlock_trywrlock"};
+    NextFunction<TimedRwlockFunction> nextRwlockTimedrdlock {"pthread_rwlock_timedrdlock"};
+    NextFunction<TimedRwlockFunction> nextRwlockTimedwrlock {"pthread_rwlock_timedwrlock"};
+    NextFunction<ClockRwlockFunction> nextRwlockClockrdlock {"pthread_rwlock_clockrdlock"};
+    NextFunction<ClockRwlockFunction> nextRwlockClockwrlock {"pthread_rwlock_clockwrlock"};
+    NextFunction<int (*)(pthread_cond_t*, pthread_mutex_t*)> nextCondWait {"pthread_cond_wait"};
+    NextFunction<int (*)(pthread_cond_t*, pthread_mutex_t*, const timespec*)> nextCondTimedwait {"pthread_cond_timedwait"};
+    NextFunction<int (*)(pthread_cond_t*, pthread_mutex_t*, clockid_t, const timespec*)> nextCondClockwait {"pthread_cond_clockwait"};
+
+    std::atomic<std::uint64_t> numViolations {0};
+    std::atomic<int> maxReportedViolations {20};
+
+    // Plain thread-locals of the executable are initial-exec TLS, so reading them never allocates.
+    thread_local int realtimeDepth = 0;
+    thread_local bool isReporting = false;
+
+    void writeToStderr(const char* text) noexcept
+    {
+        [[maybe_unused]] const auto written = ::write(STDERR_FILENO, text, std::strlen(text));
+    }
+
+    /** Counts a violation and prints it with a stack trace, without allocating or locking. */
+    void reportViolation(const char* functionName) noexcept
+    {
+        isReporting = true;
+
+        if (numViolations.fetch_add(1, std::memory_order_relaxed) < (std::uint64_t) maxReportedViolations.load(std::memory_order_relaxed))
+        {
+            writeToStderr("\n*** real-time violation: ");
+            writeToStderr(functionName);
+            writeToStderr(" called on a real-time thread\n");
+
+            void* frames[64];
+            const auto numFrames = ::backtrace(frames, 64);
+
+            // Skips this function, so the trace starts at the hook.
+            ::backtrace_symbols_fd(frames + 1, numFrames - 1, STDERR_FILENO);
+        }
+
+        isReporting = false;
+    }
+
+    void check(const char* functionName) noexcept
+    {
+        if (realtimeDepth > 0 && ! isReporting)
+            reportViolation(functionName);
+    }
+
+    void* allocateAligned(size_t alignment, size_t size) noexcept
+    {
+        return __libc_memalign(alignment, size);
+    }
+}
+
+void RealtimeSanitizer::initialise()
+{
+    nextMutexLock.get();
+    nextMutexTrylock.get();
+    nextMutexClocklock.get();
+    nextRwlockRdlock.get();
+    nextRwlockWrlock.get();
+    nextRwlockTryrdlock.get();
+    nextRwlockTrywrlock.get();
+    nextRwlockTimedrdlock.get();
+    nextRwlockTimedwrlock.get();
+    nextRwlockClockrdlock.get();
+    nextRwlockClockwrlock.get();
+    nextCondWait.get();
+    nextCondTimedwait.get();
+    nextCondClockwait.get();
+
+    // The first backtrace() loads libgcc_s, which allocates.
+    void* frames[4];
+    ::backtrace(frames, 4);
+}
+
+RealtimeSanitizer::ScopedRealtimeContext::ScopedRealtimeContext() noexcept { ++realtimeDepth; }
+RealtimeSanitizer::ScopedRealtimeContext::~ScopedRealtimeContext() noexcept { --realtimeDepth; }
+
+std::uint64_t RealtimeSanitizer::getNumViolations() noexcept
+{
+    return numViolations.load(std::memory_order_relaxed);
+}
+
+void RealtimeSanitizer::setMaxReportedViolations(int maxReports) noexcept
+{
+    maxReportedViolations.store(maxReports, std::memory_order_relaxed);
+}
+
+//==============================================================================
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        check("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* reallocarray(void* pointer, size_t count, size_t size)
+    {
+        check("reallocarray");
+
+        if (size != 0 && count > SIZE_MAX / size)
+        {
+            errno = ENOMEM;
+            return nullptr;
+        }
+
+        return __libc_realloc(pointer, count * size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            check("free");
+
+        __libc_free(pointer);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        check("posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = allocateAligned(alignment, size);
+        return *result != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        check("aligned_alloc");
+        return allocateAligned(alignment, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        check("memalign");
+        return allocateAligned(alignment, size);
+    }
+
+    void* valloc(size_t size)
+    {
+        check("valloc");
+        return allocateAligned((size_t) ::sysconf(_SC_PAGESIZE), size);
+    }
+
+    void* pvalloc(size_t size)
+    {
+        check("pvalloc");
+        const auto pageSize = (size_t) ::sysconf(_SC_PAGESIZE);
+        return allocateAligned(pageSize, (size + pageSize - 1) / pageSize * pageSize);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_lock");
+        return nextMutexLock.get()(mutex);
+    }
+
+    // A try lock never waits, but it still means the audio thread shares state behind a lock.
+    int pthread_mutex_trylock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_trylock");
+        return nextMutexTrylock.get()(mutex);
+    }
+
+    // The clock variants exist since glibc 2.30; std::timed_mutex, std::shared_timed_mutex
+    // and std::condition_variable use them where available.
+    int pthread_mutex_clocklock(pthread_mutex_t* mutex, clockid_t clock, const timespec* timeout)
+    {
+        check("pthread_mutex_clocklock");
+        return nextMutexClocklock.get()(mutex, clock, timeout);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_rdlock");
+        return nextRwlockRdlock.get()(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_wrlock");
+        return nextRwlockWrlock.get()(lock);
+    }
+
+    int pthread_rwlock_tryrdlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_tryrdlock");
+        return nextRwlockTryrdlock.get()(lock);
+    }
+
+    int pthread_rwlock_trywrlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_trywrlock");
+        return nextRwlockTrywrlock.get()(lock);
+    }
+
+    int pthread_rwlock_timedrdlock(pthread_rwlock_t* lock, const timespec* timeout)
+    {
+        check("pthread_rwlock_timedrdlock");
+        return nextRwlockTimedrdlock.get()(lock, timeout);
+    }
+
+    int pthread_rwlock_timedwrlock(pthread_rwlock_t* lock, const timespec* timeout)
+    {
+        check("pthread_rwlock_timedwrlock");
+        return nextRwlockTimedwrlock.get()(lock, timeout);
+    }
+
+    int pthread_rwlock_clockrdlock(pthread_rwlock_t* lock, clockid_t clock, const timespec* timeout)
+    {
+        check("pthread_rwlock_clockrdlock");
+        return nextRwlockClockrdlock.get()(lock, clock, timeout);
+    }
+
+    int pthread_rwlock_clockwrlock(pthread_rwlock_t* lock, clockid_t clock, const timespec* timeout)
+    {
+        check("pthread_rwlock_clockwrlock");
+        return nextRwlockClockwrlock.get()(lock, clock, timeout);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        check("pthread_cond_wait");
+        return nextCondWait.get()(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* timeout)
+    {
+        check("pthread_cond_timedwait");
+        return nextCondTimedwait.get()(condition, mutex, timeout);
+    }
+
+    int pthread_cond_clockwait(pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock, const timespec* timeout)
+    {
+        check("pthread_cond_clockwait");
+        return nextCondClockwait.get()(condition, mutex, clock, timeout);
+    }
+}
+
+//==============================================================================
+namespace
+{
+    void* allocateOrThrow(const char* functionName, size_t size)
+    {
+        check(functionName);
+
+        if (auto* pointer = __libc_malloc(size == 0 ? 1 : size))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateAlignedOrThrow(const char* functionName, size_t size, std::align_val_t alignment)
+    {
+        check(functionName);
+
+        if (auto* pointer = allocateAligned((size_t) alignment, size == 0 ? 1 : size))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            check("operator delete");
+
+        __libc_free(pointer);
+    }
+}
+
+void* operator new(size_t size) { return allocateOrThrow("operator new", size); }
+void* operator new[](size_t size) { return allocateOrThrow("operator new[]", size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow("operator new", size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow("operator new[]", size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    check("operator new");
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    check("operator new[]");
+    return __libc_malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @namespace RealtimeSanitizer
+ * @brief Detects allocations, frees, locks and condition waits on threads marked as real-time (Linux/glibc only).
+ *
+ * Linking RealtimeSanitizer.cpp into an executable replaces malloc, calloc,
+ * realloc, reallocarray, free, the aligned and page aligned allocation
+ * functions, every global operator new/delete, the pthread mutex and rwlock
+ * lock, try lock, timed and clock lock functions and the pthread condition
+ * waits with versions that forward to glibc. While a thread is inside a
+ * ScopedRealtimeContext, each of those calls counts as a violation and is
+ * reported on stderr with a stack trace. Calls on other threads, or outside
+ * the context, are only forwarded.
+ *
+ * Logging, juce::String building, std::vector growth, juce::CriticalSection
+ * and std::mutex all end up in one of the hooked functions, so they are
+ * caught without instrumenting the code under test. Not detected are spin
+ * locks, semaphores, futexes and other system calls used directly, and calls
+ * glibc makes internally, e.g. its own allocations inside stdio, which bypass
+ * the exported symbols.
+ */
+namespace RealtimeSanitizer
+{
+    /** Resolves the hooked functions and warms up the stack trace machinery. Call once at startup. */
+    void initialise();
+
+    /** Marks the calling thread as real-time for the lifetime of this object. Contexts may nest. */
+    class ScopedRealtimeContext
+    {
+    public:
+        ScopedRealtimeContext() noexcept;
+        ~ScopedRealtimeContext() noexcept;
+
+        ScopedRealtimeContext(const ScopedRealtimeContext&) = delete;
+        ScopedRealtimeContext& operator=(const ScopedRealtimeContext&) = delete;
+    };
+
+    /** Violations on all threads since startup. */
+    std::uint64_t getNumViolations() noexcept;
+
+    /** Stack traces are printed for the first maxReports violations only; later ones are just counted. */
+    void setMaxReportedViolations(int maxReports) noexcept;
+}
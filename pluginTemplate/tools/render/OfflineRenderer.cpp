@@ -0,0 +1,274 @@
+#include "OfflineRenderer.h"
+
+#include <atomic>
+
+namespace
+{
+    juce::RangedAudioParameter* findParameter(juce::AudioProcessor& processor, const juce::String& parameterID)
+    {
+        for (auto* parameter : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                if (ranged->getParameterID() == parameterID)
+                    return ranged;
+
+        return nullptr;
+    }
+
+    juce::Result applyJsonState(juce::AudioProcessor& processor, const juce::File& stateFile)
+    {
+        juce::var state;
+
+        if (const auto parsed = juce::JSON::parse(stateFile.loadFileAsString(), state); parsed.failed())
+            return juce::Result::fail(stateFile.getFullPathName() + ": " + parsed.getErrorMessage());
+
+        auto* object = state.getDynamicObject();
+
+        if (object == nullptr)
+            return juce::Result::fail(stateFile.getFullPathName() + ": expected an object of parameter values");
+
+        for (const auto& property : object->getProperties())
+        {
+            auto* parameter = findParameter(processor, property.name.toString());
+
+            if (parameter == nullptr)
+                return juce::Result::fail("Unknown parameter '" + property.name.toString() + "' in " + stateFile.getFullPathName());
+
+            const auto& value = property.value;
+            float normalisedValue;
+
+            if (value.isString())
+                normalisedValue = parameter->getValueForText(value.toString());
+            else if (value.isBool())
+                normalisedValue = (bool) value ? 1.0f : 0.0f;
+            else
+                normalisedValue = parameter->convertTo0to1((float) (double) value);
+
+            parameter->setValueNotifyingHost(normalisedValue);
+        }
+
+        return juce::Result::ok();
+    }
+
+    juce::Result applyXmlState(juce::AudioProcessor& processor, const juce::File& stateFile)
+    {
+        const auto xml = juce::XmlDocument::parse(stateFile);
+
+        if (xml == nullptr)
+            return juce::Result::fail("Could not parse " + stateFile.getFullPathName());
+
+        // Go through the processor's own state handling, exactly as a host restoring a session would.
+        juce::MemoryBlock state;
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+        processor.setStateInformation(state.getData(), (int) state.getSize());
+        return juce::Result::ok();
+    }
+
+    /** Pulls inputs off a shared counter until none are left, rendering each with its own processor. */
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(int index, juce::AudioProcessor& processorToUse, const juce::Array<juce::File>& inputsToRender,
+                     const OfflineRender::Settings& settingsToUse, std::vector<OfflineRender::FileResult>& resultsToFill,
+                     std::atomic<int>& nextInputIndex, const std::function<void(const OfflineRender::FileResult&)>& progressCallback)
+            : juce::Thread("Render worker " + juce::String(index)),
+              processor(processorToUse), inputs(inputsToRender), settings(settingsToUse),
+              results(resultsToFill), nextInput(nextInputIndex), progress(progressCallback)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        void run() override
+        {
+            for (int index = nextInput++; index < inputs.size() && ! threadShouldExit(); index = nextInput++)
+            {
+                auto& result = results[(size_t) index];
+                result = OfflineRender::renderFile(processor, formatManager, inputs[index], settings);
+
+                if (progress)
+                    progress(result);
+            }
+        }
+
+    private:
+        juce::AudioProcessor& processor;
+        juce::AudioFormatManager formatManager;
+        const juce::Array<juce::File>& inputs;
+        const OfflineRender::Settings& settings;
+        std::vector<OfflineRender::FileResult>& results;
+        std::atomic<int>& nextInput;
+        const std::function<void(const OfflineRender::FileResult&)>& progress;
+    };
+}
+
+double OfflineRender::FileResult::getRealtimeFactor() const
+{
+    return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+}
+
+juce::Result OfflineRender::applyState(juce::AudioProcessor& processor, const juce::File& stateFile)
+{
+    if (! stateFile.existsAsFile())
+        return juce::Result::fail("State file not found: " + stateFile.getFullPathName());
+
+    if (stateFile.hasFileExtension("xml"))
+        return applyXmlState(processor, stateFile);
+
+    if (stateFile.hasFileExtension("json"))
+        return applyJsonState(processor, stateFile);
+
+    juce::MemoryBlock state;
+    if (! stateFile.loadFileAsData(state))
+        return juce::Result::fail("Could not read " + stateFile.getFullPathName());
+
+    processor.setStateInformation(state.getData(), (int) state.getSize());
+    return juce::Result::ok();
+}
+
+OfflineRender::FileResult OfflineRender::renderFile(juce::AudioProcessor& processor, juce::AudioFormatManager& formatManager,
+                                                    const juce::File& input, const Settings& settings)
+{
+    FileResult fileResult;
+    fileResult.input = input;
+
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+    const auto fail = [&fileResult](const juce::String& message)
+    {
+        fileResult.result = juce::Result::fail(fileResult.input.getFileName() + ": " + message);
+        return fileResult;
+    };
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor(input));
+
+    if (reader == nullptr)
+        return fail("not a readable audio file");
+
+    const auto numChannels = (int) reader->numChannels;
+    const auto sampleRate = reader->sampleRate;
+    const auto totalSamples = reader->lengthInSamples;
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+    if (! processor.setBusesLayout(layout))
+        return fail("the processor does not support " + juce::String(numChannels) + " channels");
+
+    const auto extension = settings.outputFormat.isNotEmpty() ? settings.outputFormat
+                                                              : input.getFileExtension().trimCharactersAtStart(".");
+    auto* format = formatManager.findFormatForFileExtension(extension);
+
+    if (format == nullptr)
+        return fail("no writer for '" + extension + "' files");
+
+    fileResult.output = settings.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + "." + extension);
+
+    if (fileResult.output.exists() && ! (settings.overwrite && fileResult.output.deleteFile()))
+        return fail(fileResult.output.getFullPathName() + " already exists");
+
+    auto stream = fileResult.output.createOutputStream();
+
+    if (stream == nullptr)
+        return fail("cannot write " + fileResult.output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor(
+        stream.get(), sampleRate, (unsigned int) numChannels, settings.bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+        return fail(format->getFormatName() + " cannot write " + juce::String(numChannels) + " channels at "
+                    + juce::String(settings.bitsPerSample) + " bits");
+
+    stream.release(); // Now owned by the writer.
+
+    processor.setNonRealtime(true);
+    processor.prepareToPlay(sampleRate, settings.blockSize);
+    processor.reset();
+
+    // Drop the processor's latency from the start and keep reading (silence)
+    // past the end, so the output lines up with the input sample by sample.
+    auto samplesToSkip = (juce::int64) processor.getLatencySamples();
+    juce::int64 readPosition = 0;
+    juce::int64 samplesWritten = 0;
+
+    juce::AudioBuffer<float> buffer (numChannels, settings.blockSize);
+    juce::MidiBuffer midi;
+
+    while (samplesWritten < totalSamples)
+    {
+        // Reading beyond the end of the file fills the buffer with silence.
+        reader->read(&buffer, 0, settings.blockSize, readPosition, true, true);
+        readPosition += settings.blockSize;
+
+        processor.processBlock(buffer, midi);
+        midi.clear();
+
+        const auto numSkipped = (int) juce::jmin(samplesToSkip, (juce::int64) settings.blockSize);
+        samplesToSkip -= numSkipped;
+
+        const auto numToWrite = (int) juce::jmin((juce::int64) (settings.blockSize - numSkipped), totalSamples - samplesWritten);
+
+        if (numToWrite > 0 && ! writer->writeFromAudioSampleBuffer(buffer, numSkipped, numToWrite))
+        {
+            processor.releaseResources();
+            return fail("writing " + fileResult.output.getFullPathName() + " failed");
+        }
+
+        samplesWritten += juce::jmax(0, numToWrite);
+    }
+
+    processor.releaseResources();
+    writer.reset();
+
+    fileResult.audioSeconds = (double) totalSamples / sampleRate;
+    fileResult.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    return fileResult;
+}
+
+std::vector<OfflineRender::FileResult> OfflineRender::renderAll(const juce::Array<juce::File>& inputs, const Settings& settings,
+                                                                const ProcessorFactory& createProcessor,
+                                                                const std::function<void(const FileResult&)>& progress)
+{
+    std::vector<FileResult> results ((size_t) inputs.size());
+
+    for (int i = 0; i < inputs.size(); ++i)
+        results[(size_t) i].input = inputs[i];
+
+    // Processors are created and set up here, on the thread that owns the message manager.
+    const auto numWorkers = juce::jlimit(1, juce::jmax(1, inputs.size()), settings.numWorkers);
+    std::vector<std::unique_ptr<juce::AudioProcessor>> processors;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        processors.push_back(createProcessor());
+
+        if (settings.stateFile != juce::File())
+        {
+            if (const auto stateResult = applyState(*processors.back(), settings.stateFile); stateResult.failed())
+            {
+                for (auto& result : results)
+                {
+                    result.result = stateResult;
+
+                    if (progress)
+                        progress(result);
+                }
+
+                return results;
+            }
+        }
+    }
+
+    std::atomic<int> nextInput {0};
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<RenderWorker>(i, *processors[(size_t) i], inputs, settings,
+                                                         results, nextInput, progress));
+        workers.back()->startThread();
+    }
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    return results;
+}
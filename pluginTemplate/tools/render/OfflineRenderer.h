@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @namespace OfflineRender
+ * @brief Renders audio files through the plugin's processor without a host or editor.
+ *
+ * Files are streamed through juce::AudioFormatReader / AudioFormatWriter in
+ * large blocks as fast as the processor allows. A pool of workers renders many
+ * files in parallel, each worker with its own processor instance that is
+ * re-prepared for every file. The processor's latency is compensated, so every
+ * output is sample aligned with and as long as its input.
+ */
+namespace OfflineRender
+{
+    using ProcessorFactory = std::function<std::unique_ptr<juce::AudioProcessor>()>;
+
+    struct Settings
+    {
+        juce::File stateFile;          // Optional JSON or XML state, see applyState().
+        juce::File outputDirectory;
+        juce::String outputFormat;     // "wav" or "flac"; empty keeps the input file's format.
+        int bitsPerSample = 24;
+        int blockSize = 8192;
+        int numWorkers = 1;
+        bool overwrite = false;
+    };
+
+    struct FileResult
+    {
+        juce::File input;
+        juce::File output;
+        juce::Result result = juce::Result::ok();
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+
+        /** Seconds of audio rendered per second of wall clock time. */
+        [[nodiscard]] double getRealtimeFactor() const;
+    };
+
+    /**
+     * Sets the processor's parameters from a state file:
+     * - .xml: an XML state as written by earlier plugin versions, restored through setStateInformation().
+     * - .json: an object mapping parameter IDs to plain values, e.g.
+     *   {"GAIN": 0.5, "BYPASS": false, "OVERSAMPLING": "4x"}. Strings are parsed
+     *   with the parameter's own text conversion, so choice names work.
+     * - anything else: the raw bytes of getStateInformation(), e.g. a saved binary state.
+     */
+    juce::Result applyState(juce::AudioProcessor& processor, const juce::File& stateFile);
+
+    /** Renders one file with a processor that already has its state applied. */
+    FileResult renderFile(juce::AudioProcessor& processor, juce::AudioFormatManager& formatManager,
+                          const juce::File& input, const Settings& settings);
+
+    /**
+     * Renders all inputs on settings.numWorkers threads and returns the results
+     * in input order. progress is called once per input when it is done (or
+     * failed) from the rendering threads, so it must be thread safe.
+     */
+    std::vector<FileResult> renderAll(const juce::Array<juce::File>& inputs, const Settings& settings,
+                                      const ProcessorFactory& createProcessor,
+                                      const std::function<void(const FileResult&)>& progress = {});
+}
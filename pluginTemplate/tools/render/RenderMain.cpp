@@ -0,0 +1,143 @@
+#include "OfflineRenderer.h"
+
+#include <iostream>
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: pluginTemplateRender [options] --output-dir <dir> <files or directories...>\n"
+                     "  --output-dir <dir>       where rendered files are written (required)\n"
+                     "  --state <file>           parameter values to render with: .json, .xml or a saved state\n"
+                     "  --format <wav|flac>      output format (default: same as the input)\n"
+                     "  --bits <16|24|32>        output bit depth (default: 24)\n"
+                     "  --block-size <samples>   samples per processBlock call (default: 8192)\n"
+                     "  --jobs <count>           worker threads, one processor each (default: CPU cores)\n"
+                     "  --overwrite              replace existing output files\n";
+    }
+
+    const juce::StringArray valueOptions {"--output-dir", "--state", "--format", "--bits", "--block-size", "--jobs"};
+
+    /** Every argument that is neither an option nor an option's value, with directories expanded to their audio files. */
+    juce::Array<juce::File> findInputs(const juce::ArgumentList& arguments)
+    {
+        juce::Array<juce::File> inputs;
+
+        for (int i = 0; i < arguments.size(); ++i)
+        {
+            const auto& argument = arguments[i];
+
+            if (argument.isOption())
+            {
+                if (valueOptions.contains(argument.getLongOptionName()) && ! argument.text.containsChar('='))
+                    ++i;
+
+                continue;
+            }
+
+            const auto file = argument.resolveAsFile();
+
+            if (file.isDirectory())
+                inputs.addArray(file.findChildFiles(juce::File::findFiles, true, "*.wav;*.flac;*.aif;*.aiff"));
+            else
+                inputs.add(file);
+        }
+
+        return inputs;
+    }
+
+    int getIntOption(const juce::ArgumentList& arguments, const juce::String& option, int defaultValue)
+    {
+        const auto value = arguments.getValueForOption(option);
+        return value.isNotEmpty() ? value.getIntValue() : defaultValue;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments {argc, argv};
+
+    if (arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // Parameter attachments and timers inside the processor expect a message manager.
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    OfflineRender::Settings settings;
+    settings.outputFormat = arguments.getValueForOption("--format").toLowerCase();
+    settings.bitsPerSample = getIntOption(arguments, "--bits", settings.bitsPerSample);
+    settings.blockSize = juce::jmax(1, getIntOption(arguments, "--block-size", settings.blockSize));
+    settings.numWorkers = juce::jmax(1, getIntOption(arguments, "--jobs", juce::SystemStats::getNumCpus()));
+    settings.overwrite = arguments.containsOption("--overwrite");
+
+    if (const auto statePath = arguments.getValueForOption("--state"); statePath.isNotEmpty())
+        settings.stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(statePath);
+
+    const auto outputPath = arguments.getValueForOption("--output-dir");
+    const auto inputs = findInputs(arguments);
+
+    if (outputPath.isEmpty() || inputs.isEmpty())
+    {
+        printUsage();
+        return 2;
+    }
+
+    settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+
+    if (const auto created = settings.outputDirectory.createDirectory(); created.failed())
+    {
+        std::cerr << created.getErrorMessage() << std::endl;
+        return 2;
+    }
+
+    juce::CriticalSection outputLock;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    const auto results = OfflineRender::renderAll(inputs, settings,
+        [] { return std::unique_ptr<juce::AudioProcessor>(createPluginFilter()); },
+        [&outputLock](const OfflineRender::FileResult& result)
+        {
+            const juce::ScopedLock lock (outputLock);
+
+            if (result.result.failed())
+                std::cerr << "FAILED " << result.result.getErrorMessage() << std::endl;
+            else
+                std::cout << "OK     " << result.output.getFullPathName()
+                          << juce::String::formatted("  %.1f s audio in %.2f s, %.1fx realtime",
+                                                     result.audioSeconds, result.wallSeconds, result.getRealtimeFactor())
+                          << std::endl;
+        });
+
+    const auto wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    double audioSeconds = 0.0, renderSeconds = 0.0;
+    int numFailed = 0;
+
+    for (const auto& result : results)
+    {
+        if (result.result.failed())
+        {
+            ++numFailed;
+            continue;
+        }
+
+        audioSeconds += result.audioSeconds;
+        renderSeconds += result.wallSeconds;
+    }
+
+    // The aggregate factor is what a batch node delivers; the per worker
+    // factor is what a single processor instance sustains.
+    std::cout << juce::String::formatted("Rendered %d of %d files on %d workers: %.1f s of audio in %.2f s, "
+                                         "%.1fx realtime aggregate, %.1fx realtime per worker",
+                                         (int) results.size() - numFailed, (int) results.size(),
+                                         juce::jmin(settings.numWorkers, (int) results.size()), audioSeconds, wallSeconds,
+                                         wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0,
+                                         renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0)
+              << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "PluginProcessor.h"
+
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    using StateFormat = JucePluginTemplateAudioProcessor::StateFormat;
+
+    void printUsage()
+    {
+        std::cout << "Usage: pluginTemplateStateBenchmark [options]\n"
+                     "  --instances <counts>     comma separated instance counts (default: 1,1000)\n"
+                     "  --rounds <count>         measurements per case, the fastest is kept (default: 5)\n"
+                     "\n"
+                     "Saves and restores the state of every instance, as a host does when a session\n"
+                     "is saved or loaded, and prints one CSV row per instance count and state format.\n";
+    }
+
+    struct Result
+    {
+        int numInstances = 0;
+        StateFormat format = StateFormat::binary;
+        size_t stateSize = 0;
+        double saveMicroseconds = 0.0;
+        double loadMicroseconds = 0.0;
+    };
+
+    double getMicrosecondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+    }
+
+    /** Moves every parameter away from its default, so no format can take a shortcut. */
+    void randomiseParameters(juce::AudioProcessor& processor, juce::Random& random)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+    }
+
+    Result measure(std::vector<std::unique_ptr<JucePluginTemplateAudioProcessor>>& instances, StateFormat format, int numRounds)
+    {
+        Result result;
+        result.numInstances = (int) instances.size();
+        result.format = format;
+        result.saveMicroseconds = std::numeric_limits<double>::max();
+        result.loadMicroseconds = std::numeric_limits<double>::max();
+
+        std::vector<juce::MemoryBlock> states(instances.size());
+
+        for (int round = 0; round < numRounds; ++round)
+        {
+            auto startTicks = juce::Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < instances.size(); ++i)
+                instances[i]->getStateInformation(states[i], format);
+
+            result.saveMicroseconds = juce::jmin(result.saveMicroseconds, getMicrosecondsSince(startTicks));
+
+            startTicks = juce::Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < instances.size(); ++i)
+                instances[i]->setStateInformation(states[i].getData(), (int) states[i].getSize());
+
+            result.loadMicroseconds = juce::jmin(result.loadMicroseconds, getMicrosecondsSince(startTicks));
+        }
+
+        result.stateSize = states.empty() ? 0 : states.front().getSize();
+        return result;
+    }
+
+    juce::String toCsv(const std::vector<Result>& results)
+    {
+        juce::String csv = "instances,format,stateBytes,saveMicroseconds,loadMicroseconds,loadMicrosecondsPerInstance\n";
+
+        for (const auto& result : results)
+            csv << result.numInstances << ","
+                << (result.format == StateFormat::binary ? "binary" : "xml") << ","
+                << (int) result.stateSize << ","
+                << juce::String(result.saveMicroseconds, 1) << ","
+                << juce::String(result.loadMicroseconds, 1) << ","
+                << juce::String(result.loadMicroseconds / result.numInstances, 3) << "\n";
+
+        return csv;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments {argc, argv};
+
+    if (arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // Parameter attachments and timers inside the processor expect a message manager.
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto instanceCounts = juce::StringArray::fromTokens(arguments.getValueForOption("--instances"), ",", {});
+    instanceCounts.removeEmptyStrings();
+    if (instanceCounts.isEmpty())
+        instanceCounts = {"1", "1000"};
+
+    const auto roundsOption = arguments.getValueForOption("--rounds");
+    const auto numRounds = juce::jmax(1, roundsOption.isNotEmpty() ? roundsOption.getIntValue() : 5);
+
+    juce::Random random {42};
+    std::vector<Result> results;
+
+    for (const auto& count : instanceCounts)
+    {
+        std::vector<std::unique_ptr<JucePluginTemplateAudioProcessor>> instances;
+
+        for (int i = 0; i < juce::jmax(1, count.getIntValue()); ++i)
+        {
+            instances.emplace_back(static_cast<JucePluginTemplateAudioProcessor*>(createPluginFilter()));
+            randomiseParameters(*instances.back(), random);
+        }
+
+        for (const auto format : {StateFormat::xml, StateFormat::binary})
+            results.push_back(measure(instances, format, numRounds));
+    }
+
+    std::cout << toCsv(results) << std::endl;
+    return 0;
+}
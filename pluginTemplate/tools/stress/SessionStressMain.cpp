@@ -0,0 +1,590 @@
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    void printUsage()
+    {
+        std::cout << "Usage: pluginTemplateSessionStress [options]\n"
+                     "  --instances <counts>     comma separated instance counts (default: 1,100,1000)\n"
+                     "  --block-sizes <sizes>    comma separated host buffer sizes (default: 128,512)\n"
+                     "  --workers <counts>       comma separated worker pool sizes (default: 1, 2, 4, ... up to CPU cores)\n"
+                     "  --sample-rate <hz>       sample rate (default: 48000)\n"
+                     "  --seconds <seconds>      audio time per run (default: 2)\n"
+                     "  --state-interval <ms>    time between state saves on the message thread, 0 for none (default: 50)\n"
+                     "  --silent <fraction>      share of instances fed silence, as idle tracks are (default: 0)\n"
+                     "  --no-automation          leave the parameters alone while processing\n"
+                     "  --free-run               start each cycle right after the previous one instead of once per buffer\n"
+                     "\n"
+                     "Runs many processors as one host session: every buffer period all instances are\n"
+                     "processed by a pool of worker threads, with the float parameters automated and\n"
+                     "states saved and restored from the message thread in between. Prints one CSV row\n"
+                     "per instance count, buffer size and pool size.\n";
+    }
+
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        double seconds = 2.0;
+        int stateIntervalMs = 50;
+        double silentFraction = 0.0;
+        bool automate = true;
+        bool paced = true;
+    };
+
+    constexpr double automationHz = 0.25;
+
+    double getSecondsBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    /** Resident memory of this process in bytes, or -1 where it cannot be read. */
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        // /proc/self/statm: total and resident size in pages, then more we do not need.
+        const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+
+        if (fields.size() >= 2)
+            return fields[1].getLargeIntValue() * (juce::int64) sysconf(_SC_PAGESIZE);
+       #endif
+
+        return -1;
+    }
+
+    juce::Array<int> parseCounts(const juce::String& text, const juce::Array<int>& defaultCounts)
+    {
+        juce::Array<int> counts;
+
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.getIntValue() > 0)
+                counts.addIfNotAlreadyThere(token.getIntValue());
+
+        return counts.isEmpty() ? defaultCounts : counts;
+    }
+
+    juce::Array<int> getDefaultWorkerCounts()
+    {
+        const auto numCpus = juce::SystemStats::getNumCpus();
+        juce::Array<int> counts;
+
+        for (int count = 1; count < numCpus; count *= 2)
+            counts.add(count);
+
+        counts.add(numCpus);
+        return counts;
+    }
+
+    /**
+     * Log-scale histogram of durations with about 2 % resolution. Its size is
+     * fixed, so recording never allocates, however long the run.
+     */
+    class DurationHistogram
+    {
+    public:
+        void add(double seconds) noexcept
+        {
+            const auto nanoseconds = seconds * 1.0e9;
+            const auto bucket = nanoseconds < 1.0 ? 0 : juce::jmin(numBuckets - 1, (int) (std::log2(nanoseconds) * bucketsPerOctave));
+
+            ++counts[(size_t) bucket];
+            ++numValues;
+            total += seconds;
+            maximum = juce::jmax(maximum, seconds);
+        }
+
+        void merge(const DurationHistogram& other) noexcept
+        {
+            for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+                counts[bucket] += other.counts[bucket];
+
+            numValues += other.numValues;
+            total += other.total;
+            maximum = juce::jmax(maximum, other.maximum);
+        }
+
+        /** The duration in seconds that the given fraction of all values does not exceed. */
+        [[nodiscard]] double getPercentile(double fraction) const noexcept
+        {
+            const auto rank = juce::jmax((juce::uint64) 1, (juce::uint64) std::ceil(fraction * (double) numValues));
+            juce::uint64 count = 0;
+
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                count += counts[(size_t) bucket];
+
+                if (count >= rank)
+                    return juce::jmin(maximum, std::exp2(((double) bucket + 0.5) / bucketsPerOctave) * 1.0e-9);
+            }
+
+            return maximum;
+        }
+
+        [[nodiscard]] double getMean() const noexcept { return numValues > 0 ? total / (double) numValues : 0.0; }
+        [[nodiscard]] double getMaximum() const noexcept { return maximum; }
+
+    private:
+        static constexpr int bucketsPerOctave = 32;
+        static constexpr int numBuckets = 40 * bucketsPerOctave;   // Up to 2^40 ns, about 18 minutes.
+
+        std::array<juce::uint64, numBuckets> counts {};
+        juce::uint64 numValues = 0;
+        double total = 0.0;
+        double maximum = 0.0;
+    };
+
+    /** One plugin instance with the buffer its host hands it and the parameters automated on it. */
+    struct Instance
+    {
+        std::unique_ptr<JucePluginTemplateAudioProcessor> processor;
+        std::vector<juce::AudioParameterFloat*> automatedParameters;
+        juce::AudioBuffer<float> buffer;
+        double automationPhase = 0.0;
+        bool silent = false;
+    };
+
+    /**
+     * Mimics a host's parallel graph. Every cycle the audio thread hands out all
+     * instances to itself and the helper workers, which each take the next
+     * unprocessed instance until none is left; the cycle ends when the last one
+     * is done. In paced mode a cycle starts once per buffer period, as the audio
+     * device would call back. A cycle longer than the period is a deadline miss,
+     * i.e. a dropout, and the next one then starts right away.
+     */
+    class SessionEngine : public juce::Thread
+    {
+    public:
+        struct Result
+        {
+            DurationHistogram blockTimes;   // Of each processBlock call.
+            DurationHistogram cycleTimes;   // Of each cycle, from its start until all instances are done.
+            int numDeadlineMisses = 0;
+            bool realtime = true;           // Whether every thread got real-time scheduling.
+        };
+
+        SessionEngine(std::vector<Instance>& instancesToRun, const juce::AudioBuffer<float>& inputToUse,
+                      const Settings& settingsToUse, int numSamplesToUse, int numWorkersToUse, int numCyclesToRun)
+            : juce::Thread("Audio"),
+              instances(instancesToRun),
+              input(inputToUse),
+              settings(settingsToUse),
+              numSamples(numSamplesToUse),
+              numWorkers(juce::jmax(1, numWorkersToUse)),
+              numCycles(numCyclesToRun)
+        {
+        }
+
+        ~SessionEngine() override
+        {
+            stopThread(-1);
+        }
+
+        /** Starts the audio thread and its helpers, at real-time priority where the system allows it. */
+        void start()
+        {
+            for (int i = 1; i < numWorkers; ++i)
+            {
+                helpers.push_back(std::make_unique<Helper>(*this, i));
+                result.realtime = startWithHighestPriority(*helpers.back()) && result.realtime;
+            }
+
+            result.realtime = startWithHighestPriority(*this) && result.realtime;
+        }
+
+        /** Valid once the thread has finished. */
+        [[nodiscard]] const Result& getResult() const noexcept { return result; }
+
+        void run() override
+        {
+            const auto periodSeconds = (double) numSamples / settings.sampleRate;
+            const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(periodSeconds));
+            auto nextStart = Clock::now();
+
+            for (int cycle = 0; cycle < numCycles && ! threadShouldExit(); ++cycle)
+            {
+                if (settings.paced)
+                    std::this_thread::sleep_until(nextStart);
+
+                const auto start = Clock::now();
+                startCycle(cycle);
+                processInstances(result.blockTimes);
+
+                while (numUnfinished.load(std::memory_order_acquire) > 0)
+                    std::this_thread::yield();
+
+                const auto end = Clock::now();
+                const auto seconds = getSecondsBetween(start, end);
+                result.cycleTimes.add(seconds);
+
+                if (seconds > periodSeconds)
+                    ++result.numDeadlineMisses;
+
+                // After a dropout the device calls back right away instead of catching up.
+                nextStart = std::max(nextStart + period, end);
+            }
+
+            stopHelpers();
+        }
+
+    private:
+        class Helper : public juce::Thread
+        {
+        public:
+            Helper(SessionEngine& engineToHelp, int index)
+                : juce::Thread("Session worker " + juce::String(index)), engine(engineToHelp)
+            {
+            }
+
+            void run() override
+            {
+                engine.runHelper(blockTimes);
+            }
+
+            DurationHistogram blockTimes;
+
+        private:
+            SessionEngine& engine;
+        };
+
+        static bool startWithHighestPriority(juce::Thread& thread)
+        {
+            // Real-time scheduling needs an rtprio limit on Linux; without it the thread runs at normal priority.
+            if (thread.startRealtimeThread(juce::Thread::RealtimeOptions{}))
+                return true;
+
+            thread.startThread(juce::Thread::Priority::highest);
+            return false;
+        }
+
+        void startCycle(int cycle)
+        {
+            {
+                const std::lock_guard<std::mutex> lock (mutex);
+                cycleIndex = cycle;
+                numUnfinished.store((int) instances.size(), std::memory_order_relaxed);
+                nextInstance.store(0, std::memory_order_release);
+            }
+
+            cycleStarted.notify_all();
+        }
+
+        void runHelper(DurationHistogram& blockTimes)
+        {
+            for (int lastCycle = -1;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock (mutex);
+                    cycleStarted.wait(lock, [&] { return stopping || cycleIndex != lastCycle; });
+
+                    if (stopping)
+                        return;
+
+                    lastCycle = cycleIndex;
+                }
+
+                processInstances(blockTimes);
+            }
+        }
+
+        void stopHelpers()
+        {
+            {
+                const std::lock_guard<std::mutex> lock (mutex);
+                stopping = true;
+            }
+
+            cycleStarted.notify_all();
+
+            for (auto& helper : helpers)
+            {
+                helper->waitForThreadToExit(-1);
+                result.blockTimes.merge(helper->blockTimes);
+            }
+        }
+
+        /** Processes instances of the current cycle until all have been taken. */
+        void processInstances(DurationHistogram& blockTimes)
+        {
+            juce::MidiBuffer midi;
+
+            // Taking an index synchronises with startCycle(), which makes cycleIndex safe to read.
+            for (auto index = nextInstance.fetch_add(1, std::memory_order_acq_rel); index < (int) instances.size();
+                 index = nextInstance.fetch_add(1, std::memory_order_acq_rel))
+            {
+                auto& instance = instances[(size_t) index];
+
+                if (settings.automate)
+                {
+                    const auto time = (double) cycleIndex * numSamples / settings.sampleRate;
+                    auto phase = instance.automationPhase;
+
+                    for (auto* parameter : instance.automatedParameters)
+                    {
+                        parameter->setValueNotifyingHost(0.5f + 0.4f * (float) std::sin(juce::MathConstants<double>::twoPi * automationHz * time + phase));
+                        phase += 1.0;
+                    }
+                }
+
+                juce::AudioBuffer<float> block (instance.buffer.getArrayOfWritePointers(), instance.buffer.getNumChannels(), numSamples);
+
+                for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                {
+                    if (instance.silent)
+                        block.clear(channel, 0, numSamples);
+                    else
+                        block.copyFrom(channel, 0, input, channel % input.getNumChannels(), 0, numSamples);
+                }
+
+                const auto start = Clock::now();
+                instance.processor->processBlock(block, midi);
+                blockTimes.add(getSecondsBetween(start, Clock::now()));
+
+                numUnfinished.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+        std::vector<Instance>& instances;
+        const juce::AudioBuffer<float>& input;
+        const Settings& settings;
+        const int numSamples;
+        const int numWorkers;
+        const int numCycles;
+
+        std::vector<std::unique_ptr<Helper>> helpers;
+        Result result;
+
+        std::mutex mutex;
+        std::condition_variable cycleStarted;
+        int cycleIndex = -1;        // Written under the mutex before nextInstance is reset.
+        bool stopping = false;      // Guarded by the mutex.
+        std::atomic<int> nextInstance {std::numeric_limits<int>::max()};
+        std::atomic<int> numUnfinished {0};
+    };
+
+    struct StateTraffic
+    {
+        int numSaves = 0;
+        int numLoads = 0;
+    };
+
+    /**
+     * Saves an instance's state every interval while the engine runs, as a
+     * host's autosave does, and loads every fourth one back, as a preset
+     * recall or undo would. Runs on the message thread.
+     */
+    StateTraffic runStateTraffic(std::vector<Instance>& instances, const juce::Thread& engine, int intervalMs)
+    {
+        StateTraffic traffic;
+        juce::MemoryBlock state;
+
+        for (size_t step = 0; engine.isThreadRunning(); ++step)
+        {
+            if (intervalMs > 0)
+            {
+                auto& processor = *instances[step % instances.size()].processor;
+                processor.getStateInformation(state);
+                ++traffic.numSaves;
+
+                if (step % 4 == 3)
+                {
+                    processor.setStateInformation(state.getData(), (int) state.getSize());
+                    ++traffic.numLoads;
+                }
+            }
+
+            juce::Thread::sleep(juce::jmax(1, intervalMs));
+        }
+
+        return traffic;
+    }
+
+    juce::uint64 getSkippedBlockCount(const std::vector<Instance>& instances)
+    {
+        juce::uint64 count = 0;
+
+        for (const auto& instance : instances)
+            count += instance.processor->getSkippedBlockCount();
+
+        return count;
+    }
+
+    void prepare(std::vector<Instance>& instances, double sampleRate, int blockSize)
+    {
+        for (auto& instance : instances)
+        {
+            instance.processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance.processor->prepareToPlay(sampleRate, blockSize);
+        }
+    }
+
+    SessionEngine::Result runSession(std::vector<Instance>& instances, const juce::AudioBuffer<float>& input, const Settings& settings,
+                                     int blockSize, int numWorkers, int numCycles, StateTraffic& traffic)
+    {
+        SessionEngine engine (instances, input, settings, blockSize, numWorkers, numCycles);
+        engine.start();
+        traffic = runStateTraffic(instances, engine, settings.stateIntervalMs);
+        engine.waitForThreadToExit(-1);
+        return engine.getResult();
+    }
+
+    juce::String toMicroseconds(double seconds)
+    {
+        return juce::String(seconds * 1.0e6, 1);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments {argc, argv};
+
+    if (arguments.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // Parameter attachments and timers inside the processor expect a message manager; this thread plays the message thread.
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto instanceCounts = parseCounts(arguments.getValueForOption("--instances"), {1, 100, 1000});
+    auto blockSizes = parseCounts(arguments.getValueForOption("--block-sizes"), {128, 512});
+    const auto workerCounts = parseCounts(arguments.getValueForOption("--workers"), getDefaultWorkerCounts());
+
+    // Ascending, because memory freed by re-preparing for a smaller size may stay resident.
+    blockSizes.sort();
+
+    Settings settings;
+    settings.automate = ! arguments.containsOption("--no-automation");
+    settings.paced = ! arguments.containsOption("--free-run");
+
+    if (const auto value = arguments.getValueForOption("--sample-rate"); value.isNotEmpty())
+        settings.sampleRate = juce::jmax(8000.0, value.getDoubleValue());
+
+    if (const auto value = arguments.getValueForOption("--seconds"); value.isNotEmpty())
+        settings.seconds = juce::jmax(0.01, value.getDoubleValue());
+
+    if (const auto value = arguments.getValueForOption("--state-interval"); value.isNotEmpty())
+        settings.stateIntervalMs = juce::jmax(0, value.getIntValue());
+
+    if (const auto value = arguments.getValueForOption("--silent"); value.isNotEmpty())
+        settings.silentFraction = juce::jlimit(0.0, 1.0, value.getDoubleValue());
+
+    // The first instance pays for what all instances share, such as singletons and static tables, so it is not counted.
+    int numChannels = 0;
+    {
+        std::unique_ptr<juce::AudioProcessor> probe (createPluginFilter());
+        numChannels = juce::jmax(1, probe->getTotalNumInputChannels(), probe->getTotalNumOutputChannels());
+        probe->prepareToPlay(settings.sampleRate, blockSizes.getLast());
+    }
+
+    juce::Random random {42};
+    juce::AudioBuffer<float> input (numChannels, blockSizes.getLast());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int sample = 0; sample < input.getNumSamples(); ++sample)
+            input.setSample(channel, sample, 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+
+    std::cout << "instances,blockSize,workers,realtime,bytesPerInstance,"
+                 "blockP50Us,blockP99Us,blockMaxUs,cycleP50Us,cycleP99Us,cycleMaxUs,deadlineUs,cycles,deadlineMisses,"
+                 "dspLoadPercent,speedup,efficiency,skippedBlocks,stateSaves,stateLoads" << std::endl;
+
+    for (const auto numInstances : instanceCounts)
+    {
+        // Host buffers are allocated before the baseline, so the footprint is the processors' alone.
+        std::vector<Instance> instances ((size_t) numInstances);
+
+        for (auto& instance : instances)
+            instance.buffer.setSize(numChannels, blockSizes.getLast());
+
+        const auto baselineBytes = getResidentBytes();
+
+        for (auto& instance : instances)
+        {
+            instance.processor.reset(static_cast<JucePluginTemplateAudioProcessor*>(createPluginFilter()));
+            instance.automationPhase = random.nextDouble() * juce::MathConstants<double>::twoPi;
+            instance.silent = random.nextDouble() < settings.silentFraction;
+
+            for (auto* parameter : instance.processor->getParameters())
+                if (auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter))
+                    instance.automatedParameters.push_back(floatParameter);
+        }
+
+        for (const auto blockSize : blockSizes)
+        {
+            prepare(instances, settings.sampleRate, blockSize);
+
+            // A few unmeasured cycles touch everything prepareToPlay() allocated lazily before memory is read.
+            Settings warmUpSettings = settings;
+            warmUpSettings.paced = false;
+            warmUpSettings.stateIntervalMs = 0;
+            StateTraffic warmUpTraffic;
+            runSession(instances, input, warmUpSettings, blockSize, 1, 8, warmUpTraffic);
+
+            const auto residentBytes = getResidentBytes();
+            const auto bytesPerInstance = baselineBytes >= 0 && residentBytes >= 0
+                                        ? juce::String((residentBytes - baselineBytes) / numInstances) : juce::String();
+
+            const auto periodSeconds = blockSize / settings.sampleRate;
+            const auto numCycles = juce::jmax(1, juce::roundToInt(settings.seconds / periodSeconds));
+            double referenceWork = 0.0;   // Mean cycle time times workers of the first pool size.
+
+            for (const auto numWorkers : workerCounts)
+            {
+                const auto skippedBefore = getSkippedBlockCount(instances);
+                StateTraffic traffic;
+                const auto result = runSession(instances, input, settings, blockSize, numWorkers, numCycles, traffic);
+
+                const auto meanCycle = result.cycleTimes.getMean();
+
+                if (referenceWork == 0.0)
+                    referenceWork = meanCycle * workerCounts.getFirst();
+
+                // Relative to the first pool size, normally one worker: 1.0 is perfect scaling.
+                const auto speedup = meanCycle > 0.0 ? referenceWork / workerCounts.getFirst() / meanCycle : 0.0;
+                const auto efficiency = meanCycle > 0.0 ? referenceWork / (meanCycle * numWorkers) : 0.0;
+
+                std::cout << numInstances << "," << blockSize << "," << numWorkers << ","
+                          << (result.realtime ? 1 : 0) << "," << bytesPerInstance << ","
+                          << toMicroseconds(result.blockTimes.getPercentile(0.5)) << ","
+                          << toMicroseconds(result.blockTimes.getPercentile(0.99)) << ","
+                          << toMicroseconds(result.blockTimes.getMaximum()) << ","
+                          << toMicroseconds(result.cycleTimes.getPercentile(0.5)) << ","
+                          << toMicroseconds(result.cycleTimes.getPercentile(0.99)) << ","
+                          << toMicroseconds(result.cycleTimes.getMaximum()) << ","
+                          << toMicroseconds(periodSeconds) << ","
+                          << numCycles << "," << result.numDeadlineMisses << ","
+                          << juce::String(100.0 * meanCycle / periodSeconds, 1) << ","
+                          << juce::String(speedup, 2) << ","
+                          << juce::String(efficiency, 2) << ","
+                          << (getSkippedBlockCount(instances) - skippedBefore) << ","
+                          << traffic.numSaves << "," << traffic.numLoads << std::endl;
+            }
+        }
+
+        for (auto& instance : instances)
+            instance.processor->releaseResources();
+    }
+
+    return 0;
+}